@@ -1,8 +1,21 @@
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include <unistd.h>
+
 #include "nexusalloc/nexusalloc.hpp"
 
 using namespace nexusalloc;
@@ -65,6 +78,38 @@ static void BM_Malloc_Large(benchmark::State& state) {
 }
 BENCHMARK(BM_Malloc_Large);
 
+// Arena lookup alone, as done by allocate()/deallocate(): the initial-exec pointer is one
+// %fs-relative load and a null test, while a function-local thread_local object with a
+// constructor and destructor also tests a TLS init guard. In this static executable both measure
+// about the same; the shared-library case, where only the latter calls __tls_get_addr, is checked
+// by the TlsModel tests in tests/CMakeLists.txt.
+struct GuardedArena {
+  GuardedArena() noexcept { benchmark::ClobberMemory(); }
+  ~GuardedArena() { benchmark::ClobberMemory(); }
+  int64_t value{0};
+};
+
+[[gnu::noinline]] static ThreadArena* lookup_initial_exec() { return &ThreadArena::get(); }
+
+[[gnu::noinline]] static GuardedArena* lookup_guarded_thread_local() {
+  thread_local GuardedArena arena;
+  return &arena;
+}
+
+static void BM_ArenaLookup_InitialExec(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lookup_initial_exec());
+  }
+}
+BENCHMARK(BM_ArenaLookup_InitialExec);
+
+static void BM_ArenaLookup_GuardedThreadLocal(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lookup_guarded_thread_local());
+  }
+}
+BENCHMARK(BM_ArenaLookup_GuardedThreadLocal);
+
 // Benchmark allocation only (batch)
 static void BM_NexusAlloc_BatchAlloc(benchmark::State& state) {
   const size_t batch_size = static_cast<size_t>(state.range(0));
@@ -98,6 +143,45 @@ static void BM_Malloc_BatchAlloc(benchmark::State& state) {
 }
 BENCHMARK(BM_Malloc_BatchAlloc)->Range(8, 1024);
 
+// Request-handler pattern: build thousands of short-lived nodes, then drop them all at once
+struct RequestNode {
+  RequestNode* next;
+  uint64_t payload[5];
+};
+
+static void BM_NexusAlloc_RequestNodes(benchmark::State& state) {
+  const size_t num_nodes = static_cast<size_t>(state.range(0));
+  std::vector<void*> nodes(num_nodes);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < num_nodes; ++i) {
+      nodes[i] = allocate(sizeof(RequestNode));
+    }
+    benchmark::DoNotOptimize(nodes.data());
+    for (size_t i = 0; i < num_nodes; ++i) {
+      deallocate(nodes[i], sizeof(RequestNode));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_nodes));
+}
+BENCHMARK(BM_NexusAlloc_RequestNodes)->Arg(1000)->Arg(10000);
+
+static void BM_Region_RequestNodes(benchmark::State& state) {
+  const size_t num_nodes = static_cast<size_t>(state.range(0));
+  std::vector<void*> nodes(num_nodes);
+  Region region;
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < num_nodes; ++i) {
+      nodes[i] = region.allocate(sizeof(RequestNode), alignof(RequestNode));
+    }
+    benchmark::DoNotOptimize(nodes.data());
+    region.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_nodes));
+}
+BENCHMARK(BM_Region_RequestNodes)->Arg(1000)->Arg(10000);
+
 // Benchmark various size classes
 static void BM_NexusAlloc_SizeClasses(benchmark::State& state) {
   const size_t size = static_cast<size_t>(state.range(0));
@@ -148,6 +232,27 @@ static void BM_Vector_StdAlloc(benchmark::State& state) {
 }
 BENCHMARK(BM_Vector_StdAlloc)->Range(8, 4096);
 
+// Node-based container: one allocator call per insert and erase
+template <typename Allocator>
+static void BM_Map(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+
+  for (auto _ : state) {
+    std::map<int, int, std::less<int>, Allocator> map;
+    for (int i = 0; i < n; ++i) {
+      map.emplace(i, i);
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_Map<NexusAllocator<std::pair<const int, int>>>)
+    ->Name("BM_Map_NexusAlloc")
+    ->Range(8, 4096);
+BENCHMARK(BM_Map<std::allocator<std::pair<const int, int>>>)
+    ->Name("BM_Map_StdAlloc")
+    ->Range(8, 4096);
+
 // Multi-threaded benchmark
 static void BM_NexusAlloc_MultiThreaded(benchmark::State& state) {
   for (auto _ : state) {
@@ -167,4 +272,404 @@ static void BM_Malloc_MultiThreaded(benchmark::State& state) {
 }
 BENCHMARK(BM_Malloc_MultiThreaded)->Threads(1)->Threads(2)->Threads(4)->Threads(8);
 
+// Thread churn, as in an RPC server spawning a thread per call: each short-lived thread allocates
+// and frees a few hundred blocks across several size classes. Only that work is timed, not the
+// thread spawn. Arg 0 is ThreadArena's pool limit: with 0 every thread builds its slabs from
+// scratch, otherwise it adopts a parked warm arena. Run with NEXUSALLOC_CONF=decay_ms:0 to see
+// the cost of cold slabs when exited threads' chunks are unmapped rather than pooled.
+static void BM_NexusAlloc_ThreadChurn(benchmark::State& state) {
+  ThreadArena::set_pool_limit(static_cast<size_t>(state.range(0)));
+  ThreadArena::release_parked();
+  constexpr size_t kSizes[] = {32, 64, 256, 1024, 4096};
+  constexpr size_t kBlocksPerSize = 64;
+
+  for (auto _ : state) {
+    std::thread([&state, &kSizes] {
+      const auto start = std::chrono::steady_clock::now();
+      std::vector<void*> ptrs;
+      ptrs.reserve(std::size(kSizes) * kBlocksPerSize);
+      for (size_t size : kSizes) {
+        for (size_t i = 0; i < kBlocksPerSize; ++i) {
+          ptrs.push_back(allocate(size));
+        }
+      }
+      benchmark::DoNotOptimize(ptrs.data());
+      size_t i = 0;
+      for (size_t size : kSizes) {
+        for (size_t j = 0; j < kBlocksPerSize; ++j) {
+          deallocate(ptrs[i++], size);
+        }
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      state.SetIterationTime(elapsed.count());
+    }).join();
+  }
+
+  ThreadArena::release_parked();
+  ThreadArena::reset_pool_limit();
+}
+BENCHMARK(BM_NexusAlloc_ThreadChurn)->Arg(0)->Arg(16)->UseManualTime();
+
+// Resident set size of this process in bytes (from /proc/self/statm)
+static size_t current_rss_bytes() {
+  FILE* f = std::fopen("/proc/self/statm", "r");
+  if (f == nullptr) return 0;
+  unsigned long pages_total = 0;
+  unsigned long pages_resident = 0;
+  const int matched = std::fscanf(f, "%lu %lu", &pages_total, &pages_resident);
+  std::fclose(f);
+  if (matched != 2) return 0;
+  return static_cast<size_t>(pages_resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Long-running churn on one heap: blocks get lifetimes from 1 to 64 cycles, and the allocation
+// rate drops 16x for 128 cycles out of every 256. Once a drop's long-lived blocks die, the slabs
+// can only drain if new allocations stay out of the sparse ones. Reports the slabs held, averaged
+// over all cycles, and the RSS at the end, after returned chunks are unmapped; the run stops 80
+// cycles into a low phase, while the policies still differ. Arg 0 is the SlabSelection. The heap
+// keeps the default empty slab limit, so every slab the policy lets drain past the one kept per
+// class shows up in both counters.
+static void BM_Heap_FragmentationChurn(benchmark::State& state) {
+  constexpr size_t kSizes[] = {1024, 4096, 16384};
+  constexpr size_t kMaxBatch = 2048;
+  constexpr size_t kPhase = 128;     // Cycles of high, then of low load
+  constexpr size_t kLongLived = 64;  // Lifetimes are powers of two up to this many cycles
+  constexpr double kBytesPerMiB = 1024.0 * 1024.0;
+
+  HugepageProvider::purge();
+  const size_t rss_before = current_rss_bytes();
+  Heap heap;
+  heap.set_slab_selection(static_cast<SlabSelection>(state.range(0)));
+
+  struct Block {
+    void* ptr;
+    size_t size;
+  };
+  // Blocks by the cycle they die in
+  std::vector<std::vector<Block>> deaths(kLongLived + 1);
+  std::mt19937_64 rng{42};
+  size_t slabs = 0;
+  size_t cycle = 0;
+  for (auto _ : state) {
+    auto& dying = deaths[cycle % deaths.size()];
+    for (const Block& block : dying) {
+      heap.deallocate(block.ptr, block.size);
+    }
+    dying.clear();
+    const size_t batch = (cycle / kPhase) % 2 == 0 ? kMaxBatch : kMaxBatch / 16;
+    for (size_t i = 0; i < batch; ++i) {
+      const size_t size = kSizes[rng() % std::size(kSizes)];
+      const size_t lifetime = size_t{1} << (rng() % (std::countr_zero(kLongLived) + 1));
+      deaths[(cycle + lifetime) % deaths.size()].push_back({heap.allocate(size), size});
+    }
+    slabs += heap.chunk_count();
+    ++cycle;
+  }
+  HugepageProvider::purge();
+  const size_t rss_after = current_rss_bytes();
+
+  state.counters["slabs"] = static_cast<double>(slabs) / static_cast<double>(cycle);
+  state.counters["rss_MiB"] =
+      static_cast<double>(rss_after > rss_before ? rss_after - rss_before : 0) / kBytesPerMiB;
+  for (const auto& blocks : deaths) {
+    for (const Block& block : blocks) {
+      heap.deallocate(block.ptr, block.size);
+    }
+  }
+}
+BENCHMARK(BM_Heap_FragmentationChurn)
+    ->Arg(static_cast<int64_t>(SlabSelection::kFullest))
+    ->Arg(static_cast<int64_t>(SlabSelection::kNewest))
+    ->Iterations(7 * 256 + 128 + 80);  // Ends 80 cycles into the 8th low phase
+
+// dTLB-miss-heavy random access: pointer-chase through 64-byte objects spread over a large working
+// set, visiting them in random order so nearly every hop lands on a different page. NexusAlloc
+// chunks are taken straight from HugepageProvider in the PageMode under test (arg 0) and carved
+// by Slab<64>, so the page size backing the objects is controlled per run. Arg 1 is the working
+// set in MB.
+struct ChaseNode {
+  ChaseNode* next;
+  char payload[56];
+};
+static_assert(sizeof(ChaseNode) == 64);
+
+static void run_pointer_chase(benchmark::State& state, std::vector<ChaseNode*>& nodes) {
+  std::shuffle(nodes.begin(), nodes.end(), std::mt19937_64{42});
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    nodes[i]->next = nodes[(i + 1) % nodes.size()];
+  }
+
+  constexpr size_t kHopsPerIteration = 1024;
+  ChaseNode* current = nodes.front();
+  for (auto _ : state) {
+    for (size_t i = 0; i < kHopsPerIteration; ++i) {
+      current = current->next;
+    }
+    benchmark::DoNotOptimize(current);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kHopsPerIteration));
+}
+
+static void BM_NexusAlloc_RandomAccess(benchmark::State& state) {
+  const auto mode = static_cast<PageMode>(state.range(0));
+  const size_t working_set = static_cast<size_t>(state.range(1)) * 1024 * 1024;
+  const size_t num_chunks = working_set / PageTraits::kChunkSize;
+
+  const PageMode original_mode = HugepageProvider::page_mode();
+  HugepageProvider::set_page_mode(mode);
+
+  std::vector<std::unique_ptr<Slab<64>>> slabs;
+  std::vector<ChaseNode*> nodes;
+  nodes.reserve(working_set / sizeof(ChaseNode));
+  for (size_t c = 0; c < num_chunks; ++c) {
+    void* chunk = HugepageProvider::allocate_chunk();
+    if (chunk == nullptr) break;
+    slabs.push_back(std::make_unique<Slab<64>>(chunk));
+    while (void* block = slabs.back()->allocate()) {
+      nodes.push_back(static_cast<ChaseNode*>(block));
+    }
+  }
+
+  if (nodes.empty()) {
+    state.SkipWithError("failed to allocate chunks");
+  } else {
+    run_pointer_chase(state, nodes);
+  }
+
+  static constexpr const char* kModeNames[] = {"4K", "THP", "2M", "1G"};
+  state.SetLabel(kModeNames[static_cast<size_t>(mode)]);
+
+  for (auto& slab : slabs) {
+    HugepageProvider::deallocate_chunk(slab->base());
+  }
+  HugepageProvider::set_page_mode(original_mode);
+}
+BENCHMARK(BM_NexusAlloc_RandomAccess)
+    ->Args({static_cast<int64_t>(PageMode::kRegular), 64})
+    ->Args({static_cast<int64_t>(PageMode::kTransparent), 64})
+    ->Args({static_cast<int64_t>(PageMode::kHugetlb2M), 64})
+    ->Args({static_cast<int64_t>(PageMode::kHugetlb1G), 64})
+    ->Args({static_cast<int64_t>(PageMode::kRegular), 512})
+    ->Args({static_cast<int64_t>(PageMode::kTransparent), 512})
+    ->Args({static_cast<int64_t>(PageMode::kHugetlb2M), 512})
+    ->Args({static_cast<int64_t>(PageMode::kHugetlb1G), 512});
+
+static void BM_Malloc_RandomAccess(benchmark::State& state) {
+  const size_t working_set = static_cast<size_t>(state.range(1)) * 1024 * 1024;
+
+  std::vector<ChaseNode*> nodes(working_set / sizeof(ChaseNode));
+  for (auto& node : nodes) {
+    node = static_cast<ChaseNode*>(malloc(sizeof(ChaseNode)));
+  }
+
+  run_pointer_chase(state, nodes);
+
+  for (ChaseNode* node : nodes) {
+    free(node);
+  }
+}
+BENCHMARK(BM_Malloc_RandomAccess)->Args({0, 64})->Args({0, 512});
+
+// Cache conflicts between the hot first blocks of many slabs: every class up to 2KB gets
+// `state.range(1)` slabs, each on its own chunk, and the first four blocks of every slab are read
+// over and over. Chunks are 2MB-aligned, so without coloring (arg 0 == 0) all block 0s share one
+// L1 set and one L2 set and evict each other; with it (arg 0 == 1) slab i starts i colors in.
+constexpr size_t kHotBlocksPerSlab = 4;
+
+template <size_t ClassIndex>
+static void carve_hot_blocks(void* chunk, size_t color, std::vector<uint64_t*>& hot) {
+  Slab<internal::kBlockSizeForClass<ClassIndex>> slab(chunk, color);
+  for (size_t i = 0; i < kHotBlocksPerSlab; ++i) {
+    hot.push_back(static_cast<uint64_t*>(slab.allocate()));
+  }
+}
+
+// One slab of each class per round; chunks.size() is a multiple of the class count
+template <size_t... ClassIndices>
+static void carve_hot_blocks(const std::vector<void*>& chunks, bool colored,
+                             std::vector<uint64_t*>& hot, std::index_sequence<ClassIndices...>) {
+  for (size_t slab = 0; slab < chunks.size();) {
+    ((carve_hot_blocks<ClassIndices>(chunks[slab], colored ? slab : 0, hot), ++slab), ...);
+  }
+}
+
+static void BM_Slab_ColoredTraversal(benchmark::State& state) {
+  constexpr size_t kClasses = 19;  // 16 bytes to 2KB
+  static_assert(internal::kBlockSizeForClass<kClasses - 1> == 2048);
+  const bool colored = state.range(0) != 0;
+  const size_t num_slabs = kClasses * static_cast<size_t>(state.range(1));
+
+  std::vector<void*> chunks;
+  for (size_t i = 0; i < num_slabs; ++i) {
+    void* chunk = HugepageProvider::allocate_chunk();
+    if (chunk == nullptr) break;
+    chunks.push_back(chunk);
+  }
+
+  if (chunks.size() != num_slabs) {
+    state.SkipWithError("failed to allocate chunks");
+  } else {
+    std::vector<uint64_t*> hot;
+    hot.reserve(num_slabs * kHotBlocksPerSlab);
+    carve_hot_blocks(chunks, colored, hot, std::make_index_sequence<kClasses>{});
+    for (uint64_t* block : hot) {
+      *block = 1;
+    }
+    for (auto _ : state) {
+      uint64_t sum = 0;
+      for (const uint64_t* block : hot) {
+        sum += *block;
+      }
+      benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(hot.size()));
+  }
+  state.SetLabel(colored ? "colored" : "uncolored");
+
+  for (void* chunk : chunks) {
+    HugepageProvider::deallocate_chunk(chunk);
+  }
+}
+BENCHMARK(BM_Slab_ColoredTraversal)
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({0, 4})
+    ->Args({1, 4})
+    ->Args({0, 16})
+    ->Args({1, 16});
+
+// Slab engines on a churned heap: `state.range(0)` slabs of 64-byte blocks are filled, a random
+// half of the blocks is freed in random order, and a list of new nodes is then allocated slab by
+// slab and linked in allocation order, as a container built by push_back would be. The free-list
+// engine hands the holes back in the order they were freed, so walking the list jumps around
+// each chunk; the bitmap engine hands them back in address order, so the walk only moves forward.
+template <typename Engine>
+static void BM_Slab_SequentialTraversal(benchmark::State& state) {
+  static_assert(Engine::kBlockSize == sizeof(ChaseNode));
+  const size_t num_slabs = static_cast<size_t>(state.range(0));
+
+  std::vector<void*> chunks;
+  std::vector<std::unique_ptr<Engine>> slabs;
+  for (size_t i = 0; i < num_slabs; ++i) {
+    void* chunk = HugepageProvider::allocate_chunk();
+    if (chunk == nullptr) break;
+    chunks.push_back(chunk);
+    slabs.push_back(std::make_unique<Engine>(chunk));
+  }
+
+  if (chunks.size() != num_slabs) {
+    state.SkipWithError("failed to allocate chunks");
+  } else {
+    std::vector<std::pair<Engine*, void*>> blocks;
+    for (auto& slab : slabs) {
+      while (void* ptr = slab->allocate()) blocks.emplace_back(slab.get(), ptr);
+    }
+    std::shuffle(blocks.begin(), blocks.end(), std::mt19937_64{42});
+    for (size_t i = 0; i < blocks.size() / 2; ++i) {
+      blocks[i].first->deallocate(blocks[i].second);
+    }
+
+    ChaseNode head{};
+    ChaseNode* tail = &head;
+    size_t length = 0;
+    for (auto& slab : slabs) {
+      while (void* ptr = slab->allocate()) {
+        tail->next = static_cast<ChaseNode*>(ptr);
+        tail = tail->next;
+        ++length;
+      }
+    }
+    tail->next = nullptr;
+
+    for (auto _ : state) {
+      size_t count = 0;
+      for (const ChaseNode* node = head.next; node != nullptr; node = node->next) {
+        ++count;
+      }
+      benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(length));
+  }
+
+  slabs.clear();
+  for (void* chunk : chunks) {
+    HugepageProvider::deallocate_chunk(chunk);
+  }
+}
+BENCHMARK(BM_Slab_SequentialTraversal<Slab<64>>)->Arg(1)->Arg(16);
+BENCHMARK(BM_Slab_SequentialTraversal<BitmapSlab<64>>)->Arg(1)->Arg(16);
+
+// Cost of the engines themselves: a half-full slab of 64-byte blocks where each step frees a
+// random live block and allocates a new one. The free list pops and pushes a pointer stored in
+// the block; the bitmap flips bits but has to search for the lowest free one.
+template <typename Engine>
+static void BM_Slab_AllocFreeCycle(benchmark::State& state) {
+  void* chunk = HugepageProvider::allocate_chunk();
+  if (chunk == nullptr) {
+    state.SkipWithError("failed to allocate chunk");
+    return;
+  }
+  auto slab = std::make_unique<Engine>(chunk);
+
+  std::vector<void*> live(Engine::kBlocksPerSlab / 2);
+  for (void*& ptr : live) ptr = slab->allocate();
+  std::mt19937_64 rng{42};
+  for (auto _ : state) {
+    void*& victim = live[rng() % live.size()];
+    slab->deallocate(victim);
+    victim = slab->allocate();
+    benchmark::DoNotOptimize(victim);
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  slab.reset();
+  HugepageProvider::deallocate_chunk(chunk);
+}
+BENCHMARK(BM_Slab_AllocFreeCycle<Slab<64>>);
+BENCHMARK(BM_Slab_AllocFreeCycle<BitmapSlab<64>>);
+
+// Scan throughput of the kernels behind Bitmap<131072> (the 16-byte class: 2048 words) at each
+// SIMD level (arg 0: scalar, AVX2, AVX-512). Arg 1 picks the scan: 0 counts set bits, 1 looks
+// for the first clear bit of a bitmap that is full except for its last bit, the worst case of
+// find_first_clear().
+static void BM_Bitmap_Scan(benchmark::State& state) {
+  const auto level = static_cast<internal::SimdLevel>(state.range(0));
+  const bool find = state.range(1) != 0;
+  static constexpr const char* kLevelNames[] = {"scalar", "AVX2", "AVX-512"};
+  state.SetLabel(std::string(kLevelNames[state.range(0)]) + (find ? " find" : " count"));
+  if (level > internal::simd_level()) {
+    state.SkipWithError("not supported by this CPU");
+    return;
+  }
+
+  constexpr size_t kWords = internal::Bitmap<131072>::kNumWords;
+  std::vector<uint64_t> words(kWords, ~uint64_t{0});
+  words.back() &= ~(uint64_t{1} << 63);
+  for (auto _ : state) {
+    size_t result = find ? internal::find_word_not_equal(words.data(), 0, kWords, ~uint64_t{0},
+                                                         level)
+                         : internal::popcount_words(words.data(), kWords, level);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(kWords * sizeof(uint64_t)));
+}
+BENCHMARK(BM_Bitmap_Scan)->ArgsProduct({{0, 1, 2}, {0, 1}});
+
+// Bitmap<131072>::find_run_of_clear() over a bitmap with a clear bit every 64 blocks and the only
+// long enough run at the end, at the CPU's best SIMD level
+static void BM_Bitmap_FindRunOfClear(benchmark::State& state) {
+  const size_t run = static_cast<size_t>(state.range(0));
+  auto bitmap = std::make_unique<internal::Bitmap<131072>>();
+  bitmap->set_range(0, bitmap->size() - run);
+  for (size_t i = 0; i + run < bitmap->size(); i += 64) {
+    bitmap->clear(i);
+  }
+  for (auto _ : state) {
+    size_t start = bitmap->find_run_of_clear(run);
+    benchmark::DoNotOptimize(start);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bitmap->size() / 8));
+}
+BENCHMARK(BM_Bitmap_FindRunOfClear)->Arg(2)->Arg(64);
+
 BENCHMARK_MAIN();
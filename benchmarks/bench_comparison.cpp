@@ -22,18 +22,31 @@
  * 3. Random size workload
  * 4. Producer-consumer pattern (LIFO/FIFO)
  * 5. Multi-threaded contention
- * 6. Fragmentation stress test
- * 7. Real-world simulation (mixed workload)
+ * 6. Cross-thread (remote) free: producer/consumer, ping-pong and Larson
+ * 7. False sharing: Hoard cache-scratch and cache-thrash
+ * 8. Fragmentation stress test
+ * 9. Real-world simulation (mixed workload)
+ * 10. std::pmr memory resources vs std::pmr::unsynchronized_pool_resource
  */
 
 #include <benchmark/benchmark.h>
+#include <unistd.h>
 
+#include <array>
+#include <atomic>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <list>
+#include <memory_resource>
 #include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 #include "nexusalloc/nexusalloc.hpp"
+#include "nexusalloc/pmr.hpp"
 
 #ifdef NEXUSALLOC_HAS_JEMALLOC
 // Define JEMALLOC_NO_DEMANGLE to keep je_* prefixed function names
@@ -81,6 +94,24 @@ struct NexusAllocator {
   static const char* name() { return "NexusAlloc"; }
 };
 
+// NexusAlloc through the batch API: one size-class lookup and one free-list splice per slab
+struct NexusBatchAllocator : NexusAllocator {
+  static size_t alloc_batch(size_t size, void** out, size_t n) {
+    return allocate_batch(size, out, n);
+  }
+  static void dealloc_batch(void* const* ptrs, size_t n, size_t size) {
+    deallocate_batch(ptrs, n, size);
+  }
+  static const char* name() { return "NexusAllocBatchApi"; }
+};
+
+// NexusAlloc with every block on cache lines of its own (flags::isolated)
+struct NexusIsolatedAllocator {
+  static void* alloc(size_t size) { return allocate(size, flags::isolated); }
+  static void dealloc(void* ptr, size_t size) { deallocate(ptr, size, flags::isolated); }
+  static const char* name() { return "NexusAllocIsolated"; }
+};
+
 #ifdef NEXUSALLOC_HAS_JEMALLOC
 struct JemallocAllocator {
   static void* alloc(size_t size) { return jemalloc_alloc(size); }
@@ -196,11 +227,16 @@ void BM_Batch(benchmark::State& state) {
   std::vector<void*> ptrs(batch_size);
 
   for (auto _ : state) {
-    for (size_t i = 0; i < batch_size; ++i) {
-      ptrs[i] = Allocator::alloc(alloc_size);
-    }
-    for (size_t i = 0; i < batch_size; ++i) {
-      Allocator::dealloc(ptrs[i], alloc_size);
+    if constexpr (requires { Allocator::alloc_batch(alloc_size, ptrs.data(), batch_size); }) {
+      benchmark::DoNotOptimize(Allocator::alloc_batch(alloc_size, ptrs.data(), batch_size));
+      Allocator::dealloc_batch(ptrs.data(), batch_size, alloc_size);
+    } else {
+      for (size_t i = 0; i < batch_size; ++i) {
+        ptrs[i] = Allocator::alloc(alloc_size);
+      }
+      for (size_t i = 0; i < batch_size; ++i) {
+        Allocator::dealloc(ptrs[i], alloc_size);
+      }
     }
   }
   state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch_size) * 2);
@@ -216,6 +252,15 @@ BENCHMARK(BM_Batch<NexusAllocator>)
     ->Args({1000, 64})
     ->Args({10000, 64});
 
+BENCHMARK(BM_Batch<NexusBatchAllocator>)
+    ->Name("BM_NexusAlloc_BatchApi")
+    ->Args({100, 16})
+    ->Args({100, 64})
+    ->Args({100, 256})
+    ->Args({100, 1024})
+    ->Args({1000, 64})
+    ->Args({10000, 64});
+
 BENCHMARK(BM_Batch<MallocAllocator>)
     ->Name("BM_Malloc_Batch")
     ->Args({100, 16})
@@ -430,6 +475,526 @@ BENCHMARK(BM_MultiThreaded<TcmallocAllocator>)
     ->Threads(16);
 #endif
 
+// ============================================================================
+// Cross-Thread (Remote Free) Benchmarks
+// ============================================================================
+//
+// Blocks are allocated on one thread and freed on another. Threads hand blocks
+// over through bounded lock-free SPSC rings so the queue itself never takes a
+// lock or allocates. Every benchmark iteration runs one round with freshly
+// spawned threads and reports:
+//   - items/s:        blocks allocated (and remotely freed) per second
+//   - rss_MiB:        resident set size sampled while all round threads are
+//                     still alive, i.e. after the round reached steady state
+//   - rss_growth_MiB: rss_MiB minus the RSS before the first round, which
+//                     exposes remote frees that never make it back to the
+//                     allocator
+
+// Resident set size of this process in bytes (from /proc/self/statm)
+size_t current_rss_bytes() {
+  FILE* f = std::fopen("/proc/self/statm", "r");
+  if (f == nullptr) return 0;
+  unsigned long pages_total = 0;
+  unsigned long pages_resident = 0;
+  int matched = std::fscanf(f, "%lu %lu", &pages_total, &pages_resident);
+  std::fclose(f);
+  if (matched != 2) return 0;
+  return static_cast<size_t>(pages_resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+constexpr double kBytesPerMiB = 1024.0 * 1024.0;
+
+struct RemoteBlock {
+  void* ptr;
+  size_t size;
+};
+
+// Bounded single-producer/single-consumer ring buffer
+class SpscRing {
+ public:
+  static constexpr size_t kCapacity = 1024;  // Must be a power of 2
+
+  bool try_push(const RemoteBlock& block) noexcept {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == kCapacity) return false;
+    slots_[tail & (kCapacity - 1)] = block;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(RemoteBlock& block) noexcept {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return false;
+    block = slots_[head & (kCapacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  void push(const RemoteBlock& block) noexcept {
+    while (!try_push(block)) std::this_thread::yield();
+  }
+
+  // Push, calling `drain` while the ring is full. Workers that also consume a ring must keep
+  // emptying it as they wait, or a cycle of full rings deadlocks.
+  template <typename Drain>
+  void push(const RemoteBlock& block, Drain&& drain) noexcept {
+    while (!try_push(block)) {
+      drain();
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) std::array<RemoteBlock, kCapacity> slots_{};
+};
+
+// Runs one round of `num_threads` workers and samples RSS once every worker has
+// finished its work but before any of them exits (thread exit may release
+// per-thread caches, which would hide the steady-state footprint).
+template <typename Worker>
+size_t run_remote_round(size_t num_threads, Worker&& worker) {
+  std::atomic<size_t> finished{0};
+  std::atomic<bool> release{false};
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      worker(t);
+      finished.fetch_add(1, std::memory_order_acq_rel);
+      while (!release.load(std::memory_order_acquire)) std::this_thread::yield();
+    });
+  }
+
+  while (finished.load(std::memory_order_acquire) != num_threads) std::this_thread::yield();
+  size_t rss = current_rss_bytes();
+  release.store(true, std::memory_order_release);
+
+  for (auto& t : threads) t.join();
+  return rss;
+}
+
+void report_remote_rss(benchmark::State& state, size_t rss_before, size_t rss_steady) {
+  state.counters["rss_MiB"] = static_cast<double>(rss_steady) / kBytesPerMiB;
+  state.counters["rss_growth_MiB"] =
+      (static_cast<double>(rss_steady) - static_cast<double>(rss_before)) / kBytesPerMiB;
+}
+
+// xmalloc-test style producer/consumer: `producers` threads allocate blocks of
+// random size and hand each one to a consumer, `consumers` threads free them.
+// Covers 1:N, N:1 and N:M topologies.
+template <typename Allocator>
+void BM_ProducerConsumer(benchmark::State& state) {
+  const size_t producers = static_cast<size_t>(state.range(0));
+  const size_t consumers = static_cast<size_t>(state.range(1));
+  const size_t ops_per_producer = 20000;
+
+  const size_t rss_before = current_rss_bytes();
+  size_t rss_steady = 0;
+
+  for (auto _ : state) {
+    // One ring per (producer, consumer) pair keeps every ring SPSC
+    std::vector<SpscRing> rings(producers * consumers);
+    std::atomic<size_t> producers_done{0};
+
+    rss_steady = run_remote_round(producers + consumers, [&](size_t t) {
+      if (t < producers) {
+        std::mt19937 rng(static_cast<uint32_t>(t + 1));
+        std::uniform_int_distribution<size_t> size_dist(16, 512);
+        for (size_t i = 0; i < ops_per_producer; ++i) {
+          size_t size = size_dist(rng);
+          void* ptr = Allocator::alloc(size);
+          std::memset(ptr, 0xA5, 16);
+          rings[t * consumers + (i + t) % consumers].push({ptr, size});
+        }
+        producers_done.fetch_add(1, std::memory_order_release);
+        return;
+      }
+
+      const size_t c = t - producers;
+      RemoteBlock block{};
+      while (true) {
+        // Read the flag before draining so no block pushed before it is missed
+        const bool done = producers_done.load(std::memory_order_acquire) == producers;
+        bool drained_any = false;
+        for (size_t p = 0; p < producers; ++p) {
+          while (rings[p * consumers + c].try_pop(block)) {
+            Allocator::dealloc(block.ptr, block.size);
+            drained_any = true;
+          }
+        }
+        if (done && !drained_any) break;
+        if (!drained_any) std::this_thread::yield();
+      }
+    });
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(producers * ops_per_producer));
+  state.SetLabel(std::to_string(producers) + ":" + std::to_string(consumers));
+  report_remote_rss(state, rss_before, rss_steady);
+}
+
+BENCHMARK(BM_ProducerConsumer<NexusAllocator>)
+    ->Name("BM_NexusAlloc_ProducerConsumer")
+    ->Args({1, 4})
+    ->Args({4, 1})
+    ->Args({4, 4})
+    ->UseRealTime();
+
+BENCHMARK(BM_ProducerConsumer<MallocAllocator>)
+    ->Name("BM_Malloc_ProducerConsumer")
+    ->Args({1, 4})
+    ->Args({4, 1})
+    ->Args({4, 4})
+    ->UseRealTime();
+
+#ifdef NEXUSALLOC_HAS_JEMALLOC
+BENCHMARK(BM_ProducerConsumer<JemallocAllocator>)
+    ->Name("BM_Jemalloc_ProducerConsumer")
+    ->Args({1, 4})
+    ->Args({4, 1})
+    ->Args({4, 4})
+    ->UseRealTime();
+#endif
+
+#ifdef NEXUSALLOC_HAS_TCMALLOC
+BENCHMARK(BM_ProducerConsumer<TcmallocAllocator>)
+    ->Name("BM_Tcmalloc_ProducerConsumer")
+    ->Args({1, 4})
+    ->Args({4, 1})
+    ->Args({4, 4})
+    ->UseRealTime();
+#endif
+
+// xmalloc-test style ping-pong: threads are paired, each side allocates a batch,
+// sends it to its partner and frees whatever batch the partner sent back.
+template <typename Allocator>
+void BM_PingPong(benchmark::State& state) {
+  const size_t pairs = static_cast<size_t>(state.range(0));
+  const size_t rounds = 200;
+  const size_t batch = 64;
+  const size_t alloc_size = 64;
+
+  const size_t rss_before = current_rss_bytes();
+  size_t rss_steady = 0;
+
+  for (auto _ : state) {
+    // rings[2 * p] carries A -> B, rings[2 * p + 1] carries B -> A
+    std::vector<SpscRing> rings(pairs * 2);
+
+    rss_steady = run_remote_round(pairs * 2, [&](size_t t) {
+      const size_t pair = t / 2;
+      SpscRing& out = rings[2 * pair + (t & 1)];
+      SpscRing& in = rings[2 * pair + 1 - (t & 1)];
+      RemoteBlock block{};
+
+      for (size_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < batch; ++i) {
+          void* ptr = Allocator::alloc(alloc_size);
+          std::memset(ptr, 0x5A, alloc_size);
+          out.push({ptr, alloc_size});
+        }
+        for (size_t received = 0; received < batch;) {
+          if (in.try_pop(block)) {
+            Allocator::dealloc(block.ptr, block.size);
+            ++received;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      }
+    });
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(pairs * 2 * rounds * batch));
+  report_remote_rss(state, rss_before, rss_steady);
+}
+
+BENCHMARK(BM_PingPong<NexusAllocator>)
+    ->Name("BM_NexusAlloc_PingPong")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+
+BENCHMARK(BM_PingPong<MallocAllocator>)
+    ->Name("BM_Malloc_PingPong")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+
+#ifdef NEXUSALLOC_HAS_JEMALLOC
+BENCHMARK(BM_PingPong<JemallocAllocator>)
+    ->Name("BM_Jemalloc_PingPong")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+#endif
+
+#ifdef NEXUSALLOC_HAS_TCMALLOC
+BENCHMARK(BM_PingPong<TcmallocAllocator>)
+    ->Name("BM_Tcmalloc_PingPong")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+#endif
+
+// Larson-style server simulation: every worker keeps a table of live
+// "connection" objects and keeps replacing random entries with new allocations.
+// Evicted objects are handed to the next worker in the ring, which frees them
+// on its next drain, so the steady state mixes local allocations with remote
+// frees while the live working set stays constant.
+template <typename Allocator>
+void BM_Larson(benchmark::State& state) {
+  const size_t num_threads = static_cast<size_t>(state.range(0));
+  const size_t slots_per_thread = 1000;
+  const size_t ops_per_thread = 20000;
+
+  const size_t rss_before = current_rss_bytes();
+  size_t rss_steady = 0;
+
+  for (auto _ : state) {
+    std::vector<SpscRing> rings(num_threads);
+    std::atomic<size_t> workers_done{0};
+
+    rss_steady = run_remote_round(num_threads, [&](size_t t) {
+      std::mt19937 rng(static_cast<uint32_t>(t + 1));
+      std::uniform_int_distribution<size_t> size_dist(16, 256);
+      std::uniform_int_distribution<size_t> slot_dist(0, slots_per_thread - 1);
+
+      SpscRing& out = rings[(t + 1) % num_threads];
+      SpscRing& in = rings[t];
+      RemoteBlock block{};
+      std::vector<RemoteBlock> slots(slots_per_thread);
+      auto drain_in = [&] {
+        while (in.try_pop(block)) Allocator::dealloc(block.ptr, block.size);
+      };
+
+      for (auto& slot : slots) {
+        slot.size = size_dist(rng);
+        slot.ptr = Allocator::alloc(slot.size);
+      }
+
+      for (size_t i = 0; i < ops_per_thread; ++i) {
+        RemoteBlock& slot = slots[slot_dist(rng)];
+        out.push(slot, drain_in);
+        slot.size = size_dist(rng);
+        slot.ptr = Allocator::alloc(slot.size);
+        std::memset(slot.ptr, 0x3C, 16);
+
+        if ((i & 63) == 0) drain_in();
+      }
+
+      // Connections closing: hand the remaining table to the neighbour as well
+      for (const auto& slot : slots) out.push(slot, drain_in);
+      workers_done.fetch_add(1, std::memory_order_release);
+
+      while (true) {
+        const bool done = workers_done.load(std::memory_order_acquire) == num_threads;
+        bool drained_any = false;
+        while (in.try_pop(block)) {
+          Allocator::dealloc(block.ptr, block.size);
+          drained_any = true;
+        }
+        if (done && !drained_any) break;
+        if (!drained_any) std::this_thread::yield();
+      }
+    });
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_threads * ops_per_thread));
+  report_remote_rss(state, rss_before, rss_steady);
+}
+
+BENCHMARK(BM_Larson<NexusAllocator>)
+    ->Name("BM_NexusAlloc_Larson")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+BENCHMARK(BM_Larson<MallocAllocator>)
+    ->Name("BM_Malloc_Larson")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+#ifdef NEXUSALLOC_HAS_JEMALLOC
+BENCHMARK(BM_Larson<JemallocAllocator>)
+    ->Name("BM_Jemalloc_Larson")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+#endif
+
+#ifdef NEXUSALLOC_HAS_TCMALLOC
+BENCHMARK(BM_Larson<TcmallocAllocator>)
+    ->Name("BM_Tcmalloc_Larson")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+#endif
+
+// ============================================================================
+// False Sharing Benchmarks (Hoard cache-scratch / cache-thrash)
+// ============================================================================
+//
+// Small objects written by different threads slow each other down when the
+// allocator packs them into the same cache line. Both benchmarks run one round
+// of `state.range(0)` threads per iteration, each writing every byte of an
+// 8-byte object kRepetitions times per inner iteration.
+
+constexpr size_t kFalseSharingObjectSize = 8;
+constexpr size_t kFalseSharingIterations = 1000;
+constexpr size_t kFalseSharingRepetitions = 1000;
+
+void write_object(void* object) {
+  volatile char* bytes = static_cast<char*>(object);
+  for (size_t r = 0; r < kFalseSharingRepetitions; ++r) {
+    for (size_t b = 0; b < kFalseSharingObjectSize; ++b) {
+      bytes[b] = static_cast<char>(bytes[b] + 1);
+    }
+  }
+}
+
+// Passive false sharing: the main thread allocates one object per worker back to
+// back and hands them out, and the workers write their objects concurrently.
+// Hoard's version has workers free the object and allocate their own; remote
+// frees are not supported here, so the main thread frees them after the round.
+template <typename Allocator>
+void BM_CacheScratch(benchmark::State& state) {
+  const size_t num_threads = static_cast<size_t>(state.range(0));
+
+  for (auto _ : state) {
+    std::vector<void*> objects(num_threads);
+    for (auto& object : objects) {
+      object = Allocator::alloc(kFalseSharingObjectSize);
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t t = 0; t < num_threads; ++t) {
+      threads.emplace_back([object = objects[t]] {
+        for (size_t i = 0; i < kFalseSharingIterations; ++i) {
+          write_object(object);
+        }
+      });
+    }
+    for (auto& t : threads) t.join();
+
+    for (void* object : objects) {
+      Allocator::dealloc(object, kFalseSharingObjectSize);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(num_threads * kFalseSharingIterations));
+}
+
+// Active false sharing: every worker repeatedly allocates an object, writes it
+// and frees it, so any sharing comes from the allocator handing neighbouring
+// blocks to different threads.
+template <typename Allocator>
+void BM_CacheThrash(benchmark::State& state) {
+  const size_t num_threads = static_cast<size_t>(state.range(0));
+
+  for (auto _ : state) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t t = 0; t < num_threads; ++t) {
+      threads.emplace_back([] {
+        for (size_t i = 0; i < kFalseSharingIterations; ++i) {
+          void* object = Allocator::alloc(kFalseSharingObjectSize);
+          write_object(object);
+          Allocator::dealloc(object, kFalseSharingObjectSize);
+        }
+      });
+    }
+    for (auto& t : threads) t.join();
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(num_threads * kFalseSharingIterations));
+}
+
+BENCHMARK(BM_CacheScratch<NexusAllocator>)
+    ->Name("BM_NexusAlloc_CacheScratch")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+BENCHMARK(BM_CacheScratch<NexusIsolatedAllocator>)
+    ->Name("BM_NexusAllocIsolated_CacheScratch")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+BENCHMARK(BM_CacheScratch<MallocAllocator>)
+    ->Name("BM_Malloc_CacheScratch")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+#ifdef NEXUSALLOC_HAS_JEMALLOC
+BENCHMARK(BM_CacheScratch<JemallocAllocator>)
+    ->Name("BM_Jemalloc_CacheScratch")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+#endif
+#ifdef NEXUSALLOC_HAS_TCMALLOC
+BENCHMARK(BM_CacheScratch<TcmallocAllocator>)
+    ->Name("BM_Tcmalloc_CacheScratch")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+#endif
+
+BENCHMARK(BM_CacheThrash<NexusAllocator>)
+    ->Name("BM_NexusAlloc_CacheThrash")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+BENCHMARK(BM_CacheThrash<NexusIsolatedAllocator>)
+    ->Name("BM_NexusAllocIsolated_CacheThrash")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+BENCHMARK(BM_CacheThrash<MallocAllocator>)
+    ->Name("BM_Malloc_CacheThrash")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+#ifdef NEXUSALLOC_HAS_JEMALLOC
+BENCHMARK(BM_CacheThrash<JemallocAllocator>)
+    ->Name("BM_Jemalloc_CacheThrash")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+#endif
+#ifdef NEXUSALLOC_HAS_TCMALLOC
+BENCHMARK(BM_CacheThrash<TcmallocAllocator>)
+    ->Name("BM_Tcmalloc_CacheThrash")
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+#endif
+
 // ============================================================================
 // Fragmentation Stress Test
 // ============================================================================
@@ -631,6 +1196,87 @@ BENCHMARK(BM_Throughput<TcmallocAllocator>)
     ->Args({1024});
 #endif
 
+// ============================================================================
+// std::pmr Memory Resource Benchmarks
+// ============================================================================
+
+// Monotonic resources are released after every iteration, the way a per-request pmr arena is
+// used; the pooling resources keep their memory between iterations.
+template <typename Resource>
+void reset_resource(Resource& resource) {
+  if constexpr (std::is_same_v<Resource, pmr::monotonic_chunk_resource>) {
+    resource.release();
+  }
+}
+
+// Node-based container: one small allocation per element
+template <typename Resource>
+void BM_PmrList(benchmark::State& state) {
+  const size_t n = static_cast<size_t>(state.range(0));
+  Resource resource;
+
+  for (auto _ : state) {
+    {
+      std::pmr::list<int64_t> list(&resource);
+      for (size_t i = 0; i < n; ++i) {
+        list.push_back(static_cast<int64_t>(i));
+      }
+      benchmark::DoNotOptimize(list.back());
+    }
+    reset_resource(resource);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+
+// Strings of 16-512 bytes, so allocations spread over many size classes
+template <typename Resource>
+void BM_PmrStrings(benchmark::State& state) {
+  const size_t n = static_cast<size_t>(state.range(0));
+  Resource resource;
+  std::uniform_int_distribution<size_t> length_dist(16, 512);
+  std::vector<size_t> lengths(n);
+  for (auto& length : lengths) length = length_dist(tls_rng);
+
+  for (auto _ : state) {
+    {
+      std::pmr::vector<std::pmr::string> strings(&resource);
+      strings.reserve(n);
+      for (size_t length : lengths) {
+        strings.emplace_back(length, 'x');
+      }
+      benchmark::DoNotOptimize(strings.data());
+    }
+    reset_resource(resource);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+
+BENCHMARK(BM_PmrList<pmr::thread_arena_resource>)
+    ->Name("BM_Pmr_List_ThreadArena")
+    ->Arg(100)
+    ->Arg(10000);
+BENCHMARK(BM_PmrList<pmr::monotonic_chunk_resource>)
+    ->Name("BM_Pmr_List_MonotonicChunk")
+    ->Arg(100)
+    ->Arg(10000);
+BENCHMARK(BM_PmrList<std::pmr::unsynchronized_pool_resource>)
+    ->Name("BM_Pmr_List_UnsyncPool")
+    ->Arg(100)
+    ->Arg(10000);
+
+BENCHMARK(BM_PmrStrings<pmr::thread_arena_resource>)
+    ->Name("BM_Pmr_Strings_ThreadArena")
+    ->Arg(100)
+    ->Arg(10000);
+BENCHMARK(BM_PmrStrings<pmr::monotonic_chunk_resource>)
+    ->Name("BM_Pmr_Strings_MonotonicChunk")
+    ->Arg(100)
+    ->Arg(10000);
+BENCHMARK(BM_PmrStrings<std::pmr::unsynchronized_pool_resource>)
+    ->Name("BM_Pmr_Strings_UnsyncPool")
+    ->Arg(100)
+    ->Arg(10000);
+
 }  // namespace
 
 BENCHMARK_MAIN();
@@ -0,0 +1,375 @@
+/**
+ * @file bench_memory.cpp
+ * @brief Memory footprint and fragmentation benchmark (RSS over time)
+ *
+ * Unlike the Google Benchmark executables, which only measure time, this tool
+ * tracks how much memory each allocator keeps resident while a workload moves
+ * through phases:
+ * 1. grow   - build up a working set of small objects
+ * 2. shrink - free most of it in random order
+ * 3. shift  - replace the survivors with a larger size mix
+ * 4. churn  - short-lived threads allocate and free their own objects
+ * 5. drain  - free everything that is still live
+ *
+ * After every step it samples /proc/self/statm and /proc/self/smaps_rollup
+ * (Rss, AnonHugePages) plus the allocator's own statistics and prints one CSV
+ * row to stdout:
+ *
+ *   allocator,phase,step,time_ms,live_bytes,rss_bytes,anon_huge_bytes,
+ *   alloc_mapped_bytes,alloc_cached_bytes,waste_ratio
+ *
+ * alloc_mapped_bytes / alloc_cached_bytes are nexusalloc::stats() mapped bytes
+ * and pooled chunks, or mallinfo2() arena+hblkhd and fordblks for glibc.
+ * waste_ratio is the share of the workload's resident memory (RSS above the
+ * pre-workload baseline) that is not live application data.
+ *
+ * Each allocator runs in its own forked child so neither inherits the other's
+ * resident pages.
+ *
+ * `bench_memory populate` instead compares nexusalloc's chunk populate policies
+ * (eager, lazy, background) for a sidecar-style process: a few threads each
+ * make their first allocation in a few size classes. It prints
+ *
+ *   policy,page_mode,first_allocs,avg_ns,max_ns,rss_bytes,rss_growth_bytes
+ *
+ * where the latencies are those first allocations (including the page faults
+ * they trigger) and rss_growth_bytes is RSS added since before the allocations.
+ *
+ * Usage: bench_memory [nexusalloc|glibc|all|populate]   (default: all)
+ */
+
+#include <malloc.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <latch>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "nexusalloc/nexusalloc.hpp"
+
+namespace {
+
+extern "C" {
+extern void* __libc_malloc(size_t size);
+extern void __libc_free(void* ptr);
+}
+
+struct GlibcAllocator {
+  static void* alloc(size_t size) { return __libc_malloc(size); }
+  static void dealloc(void* ptr, size_t /*size*/) { __libc_free(ptr); }
+  static const char* name() { return "glibc"; }
+
+  static size_t mapped_bytes() {
+    struct mallinfo2 info = mallinfo2();
+    return info.arena + info.hblkhd;
+  }
+  static size_t cached_bytes() { return mallinfo2().fordblks; }
+};
+
+struct NexusAllocAllocator {
+  static void* alloc(size_t size) { return nexusalloc::allocate(size); }
+  static void dealloc(void* ptr, size_t size) { nexusalloc::deallocate(ptr, size); }
+  static const char* name() { return "nexusalloc"; }
+
+  static size_t mapped_bytes() { return nexusalloc::stats().mapped_bytes(); }
+  static size_t cached_bytes() {
+    return nexusalloc::stats().chunks_pooled * nexusalloc::PageTraits::kChunkSize;
+  }
+};
+
+struct MemorySample {
+  size_t rss_bytes{0};
+  size_t anon_huge_bytes{0};
+};
+
+// Reads RSS from /proc/self/statm and AnonHugePages from /proc/self/smaps_rollup.
+// Uses only stack buffers and stdio so sampling does not perturb either allocator's heap.
+MemorySample sample_memory() {
+  MemorySample sample;
+  const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+  if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+    unsigned long pages_total = 0;
+    unsigned long pages_resident = 0;
+    if (std::fscanf(f, "%lu %lu", &pages_total, &pages_resident) == 2) {
+      sample.rss_bytes = static_cast<size_t>(pages_resident) * page_size;
+    }
+    std::fclose(f);
+  }
+
+  if (FILE* f = std::fopen("/proc/self/smaps_rollup", "r")) {
+    char line[256];
+    unsigned long kb = 0;
+    while (std::fgets(line, sizeof(line), f) != nullptr) {
+      if (std::sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+        sample.anon_huge_bytes = static_cast<size_t>(kb) * 1024;
+        break;
+      }
+    }
+    std::fclose(f);
+  }
+
+  return sample;
+}
+
+struct LiveBlock {
+  void* ptr;
+  size_t size;
+};
+
+template <typename Allocator>
+class Workload {
+ public:
+  static constexpr size_t kGrowObjects = 400000;
+  static constexpr size_t kSteps = 10;
+  static constexpr size_t kChurnThreads = 4;
+  static constexpr size_t kChurnObjectsPerThread = 50000;
+
+  Workload() : rng_(42) {
+    // Reserve bookkeeping up front so it does not show up as allocator growth
+    live_.reserve(kGrowObjects * 2);
+    baseline_rss_ = sample_memory().rss_bytes;
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  void run() {
+    grow();
+    shrink();
+    shift();
+    churn();
+    drain();
+  }
+
+ private:
+  void grow() {
+    std::uniform_int_distribution<size_t> size_dist(16, 256);
+    for (size_t step = 0; step < kSteps; ++step) {
+      for (size_t i = 0; i < kGrowObjects / kSteps; ++i) allocate_one(size_dist(rng_));
+      emit("grow", step);
+    }
+  }
+
+  void shrink() {
+    // Free 90% of the working set in random order, leaving scattered survivors
+    const size_t to_free = live_.size() * 9 / 10;
+    for (size_t step = 0; step < kSteps; ++step) {
+      for (size_t i = 0; i < to_free / kSteps; ++i) free_random();
+      emit("shrink", step);
+    }
+  }
+
+  void shift() {
+    // Survivors are gradually replaced by objects from a larger size mix
+    std::uniform_int_distribution<size_t> size_dist(512, 4096);
+    const size_t survivors = live_.size();
+    for (size_t step = 0; step < kSteps; ++step) {
+      for (size_t i = 0; i < survivors / kSteps; ++i) {
+        free_random();
+        allocate_one(size_dist(rng_));
+      }
+      emit("shift", step);
+    }
+  }
+
+  void churn() {
+    for (size_t step = 0; step < kSteps; ++step) {
+      std::vector<std::thread> threads;
+      threads.reserve(kChurnThreads);
+      for (size_t t = 0; t < kChurnThreads; ++t) {
+        threads.emplace_back([t, step] {
+          std::mt19937 rng(static_cast<uint32_t>(step * kChurnThreads + t));
+          std::uniform_int_distribution<size_t> size_dist(16, 1024);
+          std::vector<LiveBlock> blocks;
+          blocks.reserve(kChurnObjectsPerThread);
+          for (size_t i = 0; i < kChurnObjectsPerThread; ++i) {
+            size_t size = size_dist(rng);
+            void* ptr = Allocator::alloc(size);
+            std::memset(ptr, 0x42, size);
+            blocks.push_back({ptr, size});
+          }
+          for (const auto& block : blocks) Allocator::dealloc(block.ptr, block.size);
+        });
+      }
+      for (auto& thread : threads) thread.join();
+      emit("churn", step);
+    }
+  }
+
+  void drain() {
+    const size_t per_step = live_.size() / kSteps + 1;
+    for (size_t step = 0; step < kSteps; ++step) {
+      for (size_t i = 0; i < per_step && !live_.empty(); ++i) free_random();
+      emit("drain", step);
+    }
+  }
+
+  void allocate_one(size_t size) {
+    void* ptr = Allocator::alloc(size);
+    std::memset(ptr, 0x24, size);  // Touch the block so it counts towards RSS
+    live_.push_back({ptr, size});
+    live_bytes_ += size;
+  }
+
+  void free_random() {
+    if (live_.empty()) return;
+    std::uniform_int_distribution<size_t> idx_dist(0, live_.size() - 1);
+    size_t idx = idx_dist(rng_);
+    Allocator::dealloc(live_[idx].ptr, live_[idx].size);
+    live_bytes_ -= live_[idx].size;
+    live_[idx] = live_.back();
+    live_.pop_back();
+  }
+
+  void emit(const char* phase, size_t step) {
+    MemorySample sample = sample_memory();
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    double time_ms = std::chrono::duration<double, std::milli>(elapsed).count();
+
+    size_t workload_rss =
+        sample.rss_bytes > baseline_rss_ ? sample.rss_bytes - baseline_rss_ : size_t{0};
+    double waste_ratio = 0.0;
+    if (workload_rss > 0) {
+      waste_ratio = 1.0 - static_cast<double>(live_bytes_) / static_cast<double>(workload_rss);
+    }
+
+    std::printf("%s,%s,%zu,%.3f,%zu,%zu,%zu,%zu,%zu,%.4f\n", Allocator::name(), phase, step,
+                time_ms, live_bytes_, sample.rss_bytes, sample.anon_huge_bytes,
+                Allocator::mapped_bytes(), Allocator::cached_bytes(), waste_ratio);
+    std::fflush(stdout);
+  }
+
+  std::mt19937 rng_;
+  std::vector<LiveBlock> live_;
+  size_t live_bytes_{0};
+  size_t baseline_rss_{0};
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Run `fn` in a forked child so each run starts from a clean process image
+template <typename Fn>
+bool run_forked(Fn&& fn) {
+  pid_t pid = fork();
+  if (pid < 0) {
+    std::perror("fork");
+    return false;
+  }
+  if (pid == 0) {
+    fn();
+    std::fflush(stdout);
+    _exit(0);
+  }
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+template <typename Allocator>
+bool run_isolated() {
+  return run_forked([] { Workload<Allocator>().run(); });
+}
+
+// First allocations of a sidecar-style process under one populate policy: kPolicyThreads threads
+// each allocate once from each of kPolicySizes' classes and hold the blocks until all threads are
+// done, so every allocation needs a chunk of its own.
+constexpr size_t kPolicyThreads = 4;
+constexpr std::array<size_t, 4> kPolicySizes = {16, 64, 256, 1024};
+
+void run_populate_policy(const char* policy_name, nexusalloc::PopulatePolicy policy,
+                         nexusalloc::PageMode page_mode) {
+  nexusalloc::initialize({.page_mode = page_mode, .populate = policy, .lock_memory = false});
+  // Give a background refill thread the head start it would get during process startup
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  const size_t baseline_rss = sample_memory().rss_bytes;
+  std::array<std::array<double, kPolicySizes.size()>, kPolicyThreads> latency_ns{};
+
+  std::latch all_allocated(kPolicyThreads);
+  std::vector<std::thread> threads;
+  threads.reserve(kPolicyThreads);
+  for (size_t t = 0; t < kPolicyThreads; ++t) {
+    threads.emplace_back([&all_allocated, &latencies = latency_ns[t]] {
+      std::array<void*, kPolicySizes.size()> ptrs{};
+      for (size_t i = 0; i < kPolicySizes.size(); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        ptrs[i] = nexusalloc::allocate(kPolicySizes[i]);
+        std::memset(ptrs[i], 0x42, kPolicySizes[i]);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        latencies[i] = std::chrono::duration<double, std::nano>(elapsed).count();
+      }
+      all_allocated.arrive_and_wait();
+      for (size_t i = 0; i < kPolicySizes.size(); ++i) {
+        nexusalloc::deallocate(ptrs[i], kPolicySizes[i]);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  const size_t rss = sample_memory().rss_bytes;
+  double total_ns = 0.0;
+  double max_ns = 0.0;
+  for (const auto& per_thread : latency_ns) {
+    for (double ns : per_thread) {
+      total_ns += ns;
+      max_ns = std::max(max_ns, ns);
+    }
+  }
+  const size_t first_allocs = kPolicyThreads * kPolicySizes.size();
+
+  std::printf("%s,%s,%zu,%.0f,%.0f,%zu,%zu\n", policy_name,
+              page_mode == nexusalloc::PageMode::kRegular ? "regular" : "thp", first_allocs,
+              total_ns / static_cast<double>(first_allocs), max_ns, rss,
+              rss > baseline_rss ? rss - baseline_rss : size_t{0});
+}
+
+bool run_populate_comparison() {
+  using nexusalloc::PageMode;
+  using nexusalloc::PopulatePolicy;
+
+  std::printf("policy,page_mode,first_allocs,avg_ns,max_ns,rss_bytes,rss_growth_bytes\n");
+  std::fflush(stdout);
+
+  bool ok = true;
+  for (PageMode mode : {PageMode::kRegular, PageMode::kTransparent}) {
+    ok &= run_forked([mode] { run_populate_policy("eager", PopulatePolicy::kEager, mode); });
+    ok &= run_forked([mode] { run_populate_policy("lazy", PopulatePolicy::kLazy, mode); });
+    ok &= run_forked(
+        [mode] { run_populate_policy("background", PopulatePolicy::kBackground, mode); });
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* which = argc > 1 ? argv[1] : "all";
+  if (std::strcmp(which, "populate") == 0) {
+    return run_populate_comparison() ? 0 : 1;
+  }
+
+  const bool all = std::strcmp(which, "all") == 0;
+  const bool nexus = all || std::strcmp(which, NexusAllocAllocator::name()) == 0;
+  const bool glibc = all || std::strcmp(which, GlibcAllocator::name()) == 0;
+
+  if (!nexus && !glibc) {
+    std::fprintf(stderr, "usage: %s [nexusalloc|glibc|all|populate]\n", argv[0]);
+    return 2;
+  }
+
+  std::printf(
+      "allocator,phase,step,time_ms,live_bytes,rss_bytes,anon_huge_bytes,"
+      "alloc_mapped_bytes,alloc_cached_bytes,waste_ratio\n");
+  std::fflush(stdout);
+
+  bool ok = true;
+  if (nexus) ok &= run_isolated<NexusAllocAllocator>();
+  if (glibc) ok &= run_isolated<GlibcAllocator>();
+  return ok ? 0 : 1;
+}
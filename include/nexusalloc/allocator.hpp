@@ -4,11 +4,15 @@
 #include <new>
 #include <type_traits>
 
+#include "nexusalloc/heap.hpp"
 #include "nexusalloc/thread_arena.hpp"
 
 namespace nexusalloc {
 
-template <typename T>
+// Stateless STL allocator over the calling thread's ThreadArena. NexusAllocator<T, Heap*> is
+// bound to an explicit Heap, and NexusAllocator<T, flags::isolated_t> gives every allocation
+// cache lines of its own.
+template <typename T, typename HeapHandle = void>
 class NexusAllocator {
  public:
   using value_type = T;
@@ -55,4 +59,114 @@ constexpr bool operator!=(const NexusAllocator<T>&, const NexusAllocator<U>&) no
   return false;
 }
 
+// Stateless allocator whose every allocation is cache-line-isolated (see flags::isolated_t), for
+// types whose instances are written by different threads: each node of a node-based container,
+// or each object made with std::allocate_shared, gets cache lines of its own.
+template <typename T>
+class NexusAllocator<T, flags::isolated_t> {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+
+  constexpr NexusAllocator() noexcept = default;
+
+  template <typename U>
+  constexpr NexusAllocator(const NexusAllocator<U, flags::isolated_t>&) noexcept {}
+
+  [[nodiscard]] T* allocate(size_type n) {
+    if (n == 0) [[unlikely]] {
+      return nullptr;
+    }
+
+    size_t bytes = n * sizeof(T);
+    void* ptr = ThreadArena::get().allocate(bytes, flags::isolated);
+
+    if (ptr == nullptr) [[unlikely]] {
+      throw std::bad_alloc();
+    }
+
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T* ptr, size_type n) noexcept {
+    if (ptr == nullptr) [[unlikely]]
+      return;
+    size_t bytes = n * sizeof(T);
+    ThreadArena::get().deallocate(ptr, bytes, flags::isolated);
+  }
+};
+
+template <typename T, typename U>
+constexpr bool operator==(const NexusAllocator<T, flags::isolated_t>&,
+                          const NexusAllocator<U, flags::isolated_t>&) noexcept {
+  return true;
+}
+
+template <typename T, typename U>
+constexpr bool operator!=(const NexusAllocator<T, flags::isolated_t>&,
+                          const NexusAllocator<U, flags::isolated_t>&) noexcept {
+  return false;
+}
+
+// Shorthand for the cache-line-isolating allocator
+template <typename T>
+using IsolatedAllocator = NexusAllocator<T, flags::isolated_t>;
+
+template <typename T>
+class NexusAllocator<T, Heap*> {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  explicit NexusAllocator(Heap* heap) noexcept : heap_(heap) {}
+
+  template <typename U>
+  NexusAllocator(const NexusAllocator<U, Heap*>& other) noexcept : heap_(other.heap()) {}
+
+  [[nodiscard]] T* allocate(size_type n) {
+    if (n == 0) [[unlikely]] {
+      return nullptr;
+    }
+
+    size_t bytes = n * sizeof(T);
+    void* ptr = heap_->allocate(bytes);
+
+    if (ptr == nullptr) [[unlikely]] {
+      throw std::bad_alloc();
+    }
+
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T* ptr, size_type n) noexcept {
+    if (ptr == nullptr) [[unlikely]]
+      return;
+    size_t bytes = n * sizeof(T);
+    heap_->deallocate(ptr, bytes);
+  }
+
+  [[nodiscard]] Heap* heap() const noexcept { return heap_; }
+
+ private:
+  Heap* heap_;
+};
+
+template <typename T, typename U>
+bool operator==(const NexusAllocator<T, Heap*>& a, const NexusAllocator<U, Heap*>& b) noexcept {
+  return a.heap() == b.heap();
+}
+
+template <typename T, typename U>
+bool operator!=(const NexusAllocator<T, Heap*>& a, const NexusAllocator<U, Heap*>& b) noexcept {
+  return a.heap() != b.heap();
+}
+
 }  // namespace nexusalloc
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <thread>
 
 namespace nexusalloc {
 
@@ -30,36 +31,69 @@ class AtomicStack {
       new_head.tag = old_head.tag + 1;  // Increment tag to prevent ABA
     } while (!head_.compare_exchange_weak(old_head, new_head, std::memory_order_release,
                                           std::memory_order_relaxed));
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Push `count` chunks already linked through their first word, from `first` to `last`, with a
+  // single CAS
+  void push_chain(void* first, void* last, size_t count) noexcept {
+    if (first == nullptr) [[unlikely]]
+      return;
+
+    Node* tail = static_cast<Node*>(last);
+    TaggedPtr old_head = head_.load(std::memory_order_relaxed);
+    TaggedPtr new_head;
+
+    do {
+      tail->next = old_head.ptr;
+      new_head.ptr = static_cast<Node*>(first);
+      new_head.tag = old_head.tag + 1;
+    } while (!head_.compare_exchange_weak(old_head, new_head, std::memory_order_release,
+                                          std::memory_order_relaxed));
+    size_.fetch_add(count, std::memory_order_relaxed);
   }
 
   [[nodiscard]] void* pop() noexcept {
-    TaggedPtr old_head = head_.load(std::memory_order_acquire);
+    // Counted so quiesce() can tell when no pop can still read a node that left the stack
+    in_flight_pops_.fetch_add(1, std::memory_order_seq_cst);
+    TaggedPtr old_head = head_.load(std::memory_order_seq_cst);
     TaggedPtr new_head;
 
     do {
       if (old_head.ptr == nullptr) [[unlikely]] {
+        in_flight_pops_.fetch_sub(1, std::memory_order_release);
         return nullptr;
       }
       new_head.ptr = old_head.ptr->next;
       new_head.tag = old_head.tag + 1;  // Increment tag to prevent ABA
-    } while (!head_.compare_exchange_weak(old_head, new_head, std::memory_order_acquire,
-                                          std::memory_order_relaxed));
+    } while (!head_.compare_exchange_weak(old_head, new_head, std::memory_order_seq_cst));
 
+    in_flight_pops_.fetch_sub(1, std::memory_order_release);
+    size_.fetch_sub(1, std::memory_order_relaxed);
     return old_head.ptr;
   }
 
+  // Wait until no pop() is in flight, so every pop() in flight on entry has returned. A pop() that
+  // loaded a node as the head reads its `next` even if another thread popped it first (the tag
+  // only makes its CAS fail), so a node's memory may only be unmapped once it has left the stack
+  // and quiesce() has returned. Spins until a moment with no pops: meant for stacks of chunks,
+  // where pops are rare.
+  void quiesce() const noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (in_flight_pops_.load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+  }
+
   [[nodiscard]] bool empty() const noexcept {
     return head_.load(std::memory_order_relaxed).ptr == nullptr;
   }
 
+  // O(1) element count. Updated after the CAS, so it may briefly lag concurrent push/pop (and
+  // transiently wrap below zero, which is clamped) but is exact once the stack is quiescent.
   [[nodiscard]] size_t approximate_size() const noexcept {
-    size_t count = 0;
-    Node* current = head_.load(std::memory_order_relaxed).ptr;
-    while (current != nullptr && count < 1000000) {  // Safety limit
-      ++count;
-      current = current->next;
-    }
-    return count;
+    auto count = static_cast<ptrdiff_t>(size_.load(std::memory_order_relaxed));
+    return count > 0 ? static_cast<size_t>(count) : 0;
   }
 
  private:
@@ -81,6 +115,8 @@ class AtomicStack {
 
   // Aligned to 16 bytes for 128-bit CAS atomic instruction
   alignas(16) std::atomic<TaggedPtr> head_{};
+  std::atomic<size_t> size_{0};
+  std::atomic<uint32_t> in_flight_pops_{0};
 };
 
 // Singleton for the global page stack
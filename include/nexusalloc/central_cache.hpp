@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "nexusalloc/internal/alignment.hpp"
+#include "nexusalloc/internal/size_class.hpp"
+#include "nexusalloc/slab.hpp"
+
+namespace nexusalloc {
+
+// Shared cache of empty slabs per size class, fed by heaps that exceed their byte budget (see
+// Heap::set_byte_budget()) and drawn from by any heap before it takes a fresh chunk. Slabs keep
+// their size class and metadata, so adopting one costs no chunk request and no slab setup.
+//
+// Sharded to keep exiting and allocating threads off a single lock: each heap pushes to and pops
+// from its home shard first, and only scans the others when that one has nothing for the class.
+class CentralCache {
+ public:
+  static constexpr size_t kShards = 8;
+
+  CentralCache() noexcept = default;
+
+  // Non-copyable, non-movable
+  CentralCache(const CentralCache&) = delete;
+  CentralCache& operator=(const CentralCache&) = delete;
+  CentralCache(CentralCache&&) = delete;
+  CentralCache& operator=(CentralCache&&) = delete;
+
+  // Cache an empty slab. Returns false (leaving `slab` untouched) if bookkeeping memory ran out.
+  bool push(internal::SlabWrapper& slab, size_t home) noexcept {
+    const size_t class_idx = slab.class_index();
+    Shard& shard = shards_[home % kShards];
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      try {
+        shard.slabs[class_idx].push_back(std::move(slab));
+      } catch (...) {
+        return false;
+      }
+    }
+    counts_[class_idx].fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Take a cached slab of the given class, or an invalid SlabWrapper if there is none. The common
+  // empty case is a single relaxed load.
+  [[nodiscard]] internal::SlabWrapper pop(size_t class_idx, size_t home) noexcept {
+    if (counts_[class_idx].load(std::memory_order_relaxed) == 0) [[likely]] {
+      return {};
+    }
+    for (size_t i = 0; i < kShards; ++i) {
+      Shard& shard = shards_[(home + i) % kShards];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto& slabs = shard.slabs[class_idx];
+      if (!slabs.empty()) {
+        internal::SlabWrapper slab = std::move(slabs.back());
+        slabs.pop_back();
+        counts_[class_idx].fetch_sub(1, std::memory_order_relaxed);
+        return slab;
+      }
+    }
+    return {};
+  }
+
+  // Slabs currently cached, across all size classes
+  [[nodiscard]] size_t slab_count() const noexcept {
+    size_t count = 0;
+    for (const auto& c : counts_) {
+      count += c.load(std::memory_order_relaxed);
+    }
+    return count;
+  }
+
+  // Hand every cached slab's chunk to `release`, e.g. Heap::return_chunk, and empty the cache.
+  // Returns the number of slabs released.
+  template <typename Release>
+  size_t release(Release&& release) noexcept {
+    size_t released = 0;
+    for (Shard& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (size_t class_idx = 0; class_idx < internal::SizeClass::kNumClasses; ++class_idx) {
+        auto& slabs = shard.slabs[class_idx];
+        for (const auto& slab : slabs) {
+          release(slab.base());
+        }
+        counts_[class_idx].fetch_sub(slabs.size(), std::memory_order_relaxed);
+        released += slabs.size();
+        slabs.clear();
+      }
+    }
+    return released;
+  }
+
+ private:
+  struct alignas(internal::kCacheLineSize) Shard {
+    std::mutex mutex;
+    std::array<std::vector<internal::SlabWrapper>, internal::SizeClass::kNumClasses> slabs;
+  };
+
+  std::array<Shard, kShards> shards_;
+  std::array<std::atomic<size_t>, internal::SizeClass::kNumClasses> counts_{};
+};
+
+// Process-wide central cache. Never destroyed, so threads still exiting during static destruction
+// can keep using it. HugepageProvider::purge() unmaps its slabs under memory pressure.
+[[nodiscard]] inline CentralCache& central_cache() noexcept {
+  alignas(CentralCache) static unsigned char storage[sizeof(CentralCache)];
+  static CentralCache* cache = [] {
+    auto* instance = new (storage) CentralCache;
+    HugepageProvider::set_cache_purger(
+        [] { central_cache().release(&HugepageProvider::deallocate_chunk); });
+    return instance;
+  }();
+  return *cache;
+}
+
+}  // namespace nexusalloc
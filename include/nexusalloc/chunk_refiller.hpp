@@ -0,0 +1,179 @@
+#pragma once
+
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "nexusalloc/atomic_stack.hpp"
+#include "nexusalloc/config.hpp"
+#include "nexusalloc/hugepage_provider.hpp"
+
+namespace nexusalloc {
+
+// Pool depths are counted in chunks. Zero watermarks run the thread for decay only.
+struct RefillOptions {
+  size_t low_watermark{4};
+  size_t high_watermark{16};
+  std::chrono::milliseconds poll_interval{10};
+  int nice_value{19};  // Thread niceness, 19 being the lowest priority
+  // Unmap pooled chunks that stayed idle this long, keeping high_watermark; negative never
+  std::chrono::milliseconds decay{config().decay_ms};
+};
+
+// Optional low-priority background thread that keeps global_page_stack() topped up, so allocating
+// threads find a pre-faulted chunk in the pool instead of calling mmap on the request path.
+//
+// Whenever the pool depth drops below `low_watermark` chunks, the thread maps and faults chunks
+// until the depth reaches `high_watermark`. It polls every `poll_interval` and is also woken
+// early by allocating threads that observe a low pool (see notify_low()).
+//
+// With a positive `decay` it also returns memory: once per decay period, chunks beyond
+// `high_watermark` that sat in the pool for the whole period are unmapped, and cached large
+// allocations are released.
+class ChunkRefiller {
+ public:
+  ChunkRefiller() = delete;
+
+  // Start the refill thread (no-op if it is already running). Returns false if the thread could
+  // not be created or the watermarks are inconsistent.
+  static bool start(const RefillOptions& options = {}) noexcept {
+    const bool decay_only = options.low_watermark == 0 && options.high_watermark == 0;
+    if ((options.low_watermark == 0 && !decay_only) ||
+        options.low_watermark > options.high_watermark) {
+      return false;
+    }
+
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.thread.joinable()) return true;
+
+    s.options = options;
+    s.stop_requested = false;
+    low_watermark_.store(options.low_watermark, std::memory_order_relaxed);
+    try {
+      s.thread = std::thread(&ChunkRefiller::run, &s);
+    } catch (...) {
+      return false;
+    }
+    running_.store(true, std::memory_order_release);
+    return true;
+  }
+
+  // Stop and join the refill thread. Chunks it already pooled stay in the pool.
+  static void stop() noexcept { stop(state()); }
+
+  [[nodiscard]] static bool running() noexcept { return running_.load(std::memory_order_acquire); }
+
+  // Called by allocating threads after taking a chunk from the pool. Only wakes the refill thread
+  // (one futex syscall) when the depth has actually dropped below the low watermark.
+  static void notify_low(size_t pool_depth) noexcept {
+    if (!running()) [[likely]] return;
+    if (pool_depth >= low_watermark_.load(std::memory_order_relaxed)) [[likely]] return;
+    wake_requested_.store(true, std::memory_order_release);
+    state().cv.notify_one();
+  }
+
+ private:
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread thread;
+    RefillOptions options;
+    bool stop_requested{false};
+
+    // Join at exit: a joinable std::thread would otherwise call std::terminate
+    ~State() { ChunkRefiller::stop(*this); }
+  };
+
+  static void stop(State& s) noexcept {
+    std::thread thread;
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+      if (!s.thread.joinable()) return;
+      s.stop_requested = true;
+      thread = std::move(s.thread);
+    }
+    s.cv.notify_one();
+    thread.join();
+    running_.store(false, std::memory_order_release);
+  }
+
+  static State& state() noexcept {
+    static State s;
+    return s;
+  }
+
+  static void run(State* s) noexcept {
+    pthread_setname_np(pthread_self(), "nexus-refill");
+    // Thread-level nice value (Linux applies PRIO_PROCESS to a single thread id)
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), s->options.nice_value);
+
+    DecayWindow window{std::chrono::steady_clock::now(), SIZE_MAX};
+    std::unique_lock<std::mutex> lock(s->mutex);
+    while (!s->stop_requested) {
+      lock.unlock();
+      refill(s->options);
+      decay(s->options, window);
+      lock.lock();
+
+      s->cv.wait_for(lock, s->options.poll_interval, [s] {
+        return s->stop_requested || wake_requested_.exchange(false, std::memory_order_acquire);
+      });
+    }
+  }
+
+  static void refill(const RefillOptions& options) noexcept {
+    AtomicStack& pool = global_page_stack();
+    if (pool.approximate_size() >= options.low_watermark) return;
+
+    // Above the soft limit, refilling would only undo the purge
+    while (pool.approximate_size() < options.high_watermark &&
+           !HugepageProvider::under_pressure()) {
+      void* chunk = HugepageProvider::allocate_refill_chunk();  // Faulted off-thread
+      if (chunk == nullptr) return;  // Out of memory or at the soft limit, retry next poll
+      pool.push(chunk);
+    }
+  }
+
+  // Smallest pool depth seen since `start`: that many chunks were idle for the whole window
+  struct DecayWindow {
+    std::chrono::steady_clock::time_point start;
+    size_t min_depth;
+  };
+
+  static void decay(const RefillOptions& options, DecayWindow& window) noexcept {
+    if (options.decay.count() <= 0) return;
+
+    AtomicStack& pool = global_page_stack();
+    window.min_depth = std::min(window.min_depth, pool.approximate_size());
+    const auto now = std::chrono::steady_clock::now();
+    if (now - window.start < options.decay) return;
+
+    for (size_t idle = window.min_depth; idle > 0; --idle) {
+      if (pool.approximate_size() <= options.high_watermark) break;
+      void* chunk = pool.pop();
+      if (chunk == nullptr) break;
+      HugepageProvider::deallocate_chunk(chunk);  // Waits for pops that may still read its link
+    }
+    HugepageProvider::trim_large_cache();
+
+    window.start = now;
+    window.min_depth = pool.approximate_size();
+  }
+
+  static inline std::atomic<bool> running_{false};
+  static inline std::atomic<size_t> low_watermark_{0};
+  static inline std::atomic<bool> wake_requested_{false};
+};
+
+}  // namespace nexusalloc
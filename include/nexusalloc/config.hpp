@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string_view>
+
+namespace nexusalloc {
+
+// Where chunks are sourced from. Every mode falls back to the next smaller page size when the
+// kernel cannot satisfy a mapping. The hugetlb modes require NEXUSALLOC_USE_HUGEPAGES and fall
+// back to kTransparent without it.
+enum class PageMode : uint8_t {
+  kRegular,      // 4KB pages only
+  kTransparent,  // 2MB-aligned chunks madvised for transparent huge pages (THP)
+  kHugetlb2M,    // One MAP_HUGETLB 2MB page per chunk (default)
+  kHugetlb1G,    // 1GB MAP_HUGETLB super-regions carved into 2MB chunks
+};
+
+inline constexpr size_t kPageModeCount = 4;
+
+// When a chunk's pages are faulted in. mlockall(MCL_FUTURE) (see lock_memory()) faults every new
+// mapping in immediately, so kLazy and kBackground only save memory without it.
+enum class PopulatePolicy : uint8_t {
+  kEager,       // Whole chunk at map time (MAP_POPULATE, default): no faults on the request path
+  kLazy,        // On first touch: resident memory only grows with the blocks actually used
+  kBackground,  // Lazy on the request path, while the refill thread pre-faults pooled chunks
+};
+
+enum class NumaPolicy : uint8_t {
+  kDefault,  // Kernel first-touch placement
+  kSpread,   // reserve() places chunks round-robin across nodes
+};
+
+// Runtime tuning read once from the NEXUSALLOC_CONF environment variable, a comma-separated list
+// of key:value pairs in the style of jemalloc's MALLOC_CONF:
+//
+//   NEXUSALLOC_CONF="page_mode:thp,populate:lazy,decay_ms:5000,large_cache:64M"
+//
+//   page_mode           regular | thp | 2m | 1g
+//   populate            eager | lazy | background
+//   decay_ms            Unmap pooled chunks idle this long; 0 unmaps on release, -1 never
+//   large_cache         Bytes of freed direct-mmap allocations kept for reuse (K/M/G suffixes)
+//   thread_cache_slabs  Empty slabs a thread keeps per size class (default 1), or "unlimited"
+//   thread_cache_bytes  Slab bytes a thread keeps before emptied slabs go to the central cache
+//   arena_pool          Exited threads' arenas kept warm for new threads; 0 frees them at exit
+//   soft_limit          Mapped bytes that trigger a purge and the pressure callback (K/M/G
+//                       suffixes), "unlimited", or "cgroup" (default): memory.high, else 90% of
+//                       memory.max
+//   hard_limit          Mapped bytes past which allocation fails, "unlimited", or "cgroup"
+//                       (default): memory.max
+//   stats               true | false: print allocator statistics to stderr at exit
+//   track_large         true | false: record thread arenas' large allocations for
+//                       for_each_live_block(), at the cost of a shared lock per large alloc/free
+//   numa                default | spread
+//
+// These are defaults: the matching setters and InitOptions fields still override them.
+struct Config {
+  static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
+  static constexpr size_t kFromCgroup = kUnlimited - 1;  // Memory limit read from cgroup v2
+
+#ifdef NEXUSALLOC_USE_HUGEPAGES
+  PageMode page_mode{PageMode::kHugetlb2M};
+#else
+  PageMode page_mode{PageMode::kRegular};
+#endif
+  PopulatePolicy populate{PopulatePolicy::kEager};
+  int64_t decay_ms{-1};
+  size_t large_cache_bytes{0};
+  size_t thread_cache_slabs{1};
+  size_t thread_cache_bytes{kUnlimited};
+  size_t arena_pool{16};
+  size_t soft_limit{kFromCgroup};
+  size_t hard_limit{kFromCgroup};
+  bool stats{false};
+  bool track_large{false};
+  NumaPolicy numa{NumaPolicy::kDefault};
+};
+
+namespace internal {
+
+template <typename T>
+[[nodiscard]] inline bool parse_integer(std::string_view text, T& out) noexcept {
+  auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), out);
+  return error == std::errc{} && end == text.data() + text.size();
+}
+
+// Byte count with an optional K, M or G suffix (powers of 1024)
+[[nodiscard]] inline bool parse_bytes(std::string_view text, size_t& out) noexcept {
+  constexpr std::string_view kSuffixes = "KMG";
+  size_t shift = 0;
+  if (!text.empty()) {
+    const char suffix = static_cast<char>(std::toupper(static_cast<unsigned char>(text.back())));
+    if (const size_t pos = kSuffixes.find(suffix); pos != std::string_view::npos) {
+      shift = 10 * (pos + 1);
+      text.remove_suffix(1);
+    }
+  }
+
+  size_t value = 0;
+  if (!parse_integer(text, value) || value > (std::numeric_limits<size_t>::max() >> shift)) {
+    return false;
+  }
+  out = value << shift;
+  return true;
+}
+
+template <typename T>
+struct NamedValue {
+  std::string_view name;
+  T value;
+};
+
+template <typename T, size_t N>
+[[nodiscard]] inline bool parse_named(std::string_view text, const NamedValue<T> (&names)[N],
+                                      T& out) noexcept {
+  for (const auto& entry : names) {
+    if (entry.name == text) {
+      out = entry.value;
+      return true;
+    }
+  }
+  return false;
+}
+
+[[nodiscard]] inline bool apply_option(Config& config, std::string_view key,
+                                       std::string_view value) noexcept {
+  static constexpr NamedValue<PageMode> kPageModes[] = {{"regular", PageMode::kRegular},
+                                                        {"thp", PageMode::kTransparent},
+                                                        {"2m", PageMode::kHugetlb2M},
+                                                        {"1g", PageMode::kHugetlb1G}};
+  static constexpr NamedValue<PopulatePolicy> kPopulatePolicies[] = {
+      {"eager", PopulatePolicy::kEager},
+      {"lazy", PopulatePolicy::kLazy},
+      {"background", PopulatePolicy::kBackground}};
+  static constexpr NamedValue<NumaPolicy> kNumaPolicies[] = {{"default", NumaPolicy::kDefault},
+                                                             {"spread", NumaPolicy::kSpread}};
+  static constexpr NamedValue<bool> kBooleans[] = {{"true", true}, {"false", false}};
+  static constexpr NamedValue<size_t> kSlabLimits[] = {{"unlimited", Config::kUnlimited}};
+  static constexpr NamedValue<size_t> kMemoryLimits[] = {{"unlimited", Config::kUnlimited},
+                                                         {"cgroup", Config::kFromCgroup}};
+
+  if (key == "page_mode") return parse_named(value, kPageModes, config.page_mode);
+  if (key == "populate") return parse_named(value, kPopulatePolicies, config.populate);
+  if (key == "decay_ms") {
+    int64_t decay_ms = 0;
+    if (!parse_integer(value, decay_ms) || decay_ms < -1) return false;
+    config.decay_ms = decay_ms;
+    return true;
+  }
+  if (key == "large_cache") return parse_bytes(value, config.large_cache_bytes);
+  if (key == "thread_cache_slabs") {
+    return parse_named(value, kSlabLimits, config.thread_cache_slabs) ||
+           parse_integer(value, config.thread_cache_slabs);
+  }
+  if (key == "thread_cache_bytes") {
+    return parse_named(value, kSlabLimits, config.thread_cache_bytes) ||
+           parse_bytes(value, config.thread_cache_bytes);
+  }
+  if (key == "soft_limit") {
+    return parse_named(value, kMemoryLimits, config.soft_limit) ||
+           parse_bytes(value, config.soft_limit);
+  }
+  if (key == "hard_limit") {
+    return parse_named(value, kMemoryLimits, config.hard_limit) ||
+           parse_bytes(value, config.hard_limit);
+  }
+  if (key == "arena_pool") return parse_integer(value, config.arena_pool);
+  if (key == "stats") return parse_named(value, kBooleans, config.stats);
+  if (key == "track_large") return parse_named(value, kBooleans, config.track_large);
+  if (key == "numa") return parse_named(value, kNumaPolicies, config.numa);
+  return false;
+}
+
+}  // namespace internal
+
+// Parse a NEXUSALLOC_CONF string. Never allocates: it runs before the allocator is usable.
+// Invalid pairs are reported on stderr and skipped; the rest still apply.
+[[nodiscard]] inline Config parse_config(const char* conf) noexcept {
+  Config config;
+  if (conf == nullptr) return config;
+
+  std::string_view rest(conf);
+  while (!rest.empty()) {
+    const size_t comma = rest.find(',');
+    const std::string_view pair = rest.substr(0, comma);
+    rest = comma == std::string_view::npos ? std::string_view{} : rest.substr(comma + 1);
+    if (pair.empty()) continue;
+
+    const size_t colon = pair.find(':');
+    if (colon == std::string_view::npos ||
+        !internal::apply_option(config, pair.substr(0, colon), pair.substr(colon + 1))) {
+      std::fprintf(stderr, "nexusalloc: ignoring invalid NEXUSALLOC_CONF option '%.*s'\n",
+                   static_cast<int>(pair.size()), pair.data());
+    }
+  }
+  return config;
+}
+
+// Process-wide configuration, parsed from NEXUSALLOC_CONF on first use
+[[nodiscard]] inline const Config& config() noexcept {
+  static const Config instance = parse_config(std::getenv("NEXUSALLOC_CONF"));
+  return instance;
+}
+
+}  // namespace nexusalloc
@@ -0,0 +1,599 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "nexusalloc/atomic_stack.hpp"
+#include "nexusalloc/central_cache.hpp"
+#include "nexusalloc/chunk_refiller.hpp"
+#include "nexusalloc/config.hpp"
+#include "nexusalloc/hugepage_provider.hpp"
+#include "nexusalloc/internal/alignment.hpp"
+#include "nexusalloc/internal/partial_slabs.hpp"
+#include "nexusalloc/internal/size_class.hpp"
+#include "nexusalloc/slab.hpp"
+
+namespace nexusalloc {
+
+namespace flags {
+
+// Tag for cache-line-isolated allocation, passed like std::nothrow. The block is rounded up to
+// whole cache lines and starts on one, so no other allocation shares its lines: objects handed to
+// other threads to write (per-connection counters, say) cannot false-share with their neighbours.
+// Free with the same tag.
+struct isolated_t {
+  explicit isolated_t() = default;
+};
+inline constexpr isolated_t isolated{};
+
+}  // namespace flags
+
+// How a heap picks the partial slab to allocate from once its current slab is full
+enum class SlabSelection : uint8_t {
+  kFullest,  // Fullest non-full slab, so sparse slabs drain and can be released (default)
+  kNewest,   // Slab most recently freed into, whatever its occupancy
+};
+
+// Slab heap with one bin of slabs per size class. Not thread-safe: ThreadArena gives every thread
+// its own heap for the default allocate()/deallocate() path, and standalone heaps isolate a
+// tenant's or subsystem's memory so it can be measured and freed wholesale with destroy().
+class Heap {
+ public:
+  Heap() noexcept = default;
+  ~Heap() { destroy(); }
+
+  // Non-copyable, non-movable
+  Heap(const Heap&) = delete;
+  Heap& operator=(const Heap&) = delete;
+  Heap(Heap&&) = delete;
+  Heap& operator=(Heap&&) = delete;
+
+  [[nodiscard, gnu::hot]] void* allocate(size_t size) noexcept {
+    // Treat size 0 as minimum allocation (matches jemalloc behavior)
+    // SizeClass::index(0) returns 0, which maps to 16 bytes
+
+    if (internal::SizeClass::is_large(size)) [[unlikely]] {
+      return allocate_large(size);
+    }
+
+    size_t class_idx = internal::SizeClass::index(size);
+    auto& bin = bins_[class_idx];
+
+    // Fast path: try current slab (this is the only code that gets inlined aggressively)
+    if (bin.current_slab.valid()) [[likely]] {
+      void* ptr = bin.current_slab.allocate();
+      if (ptr != nullptr) [[likely]] {
+        return ptr;
+      }
+    }
+
+    // Slow path: current slab is full or doesn't exist - not inlined to reduce code size and keep
+    // hot code in the I-cache
+    return allocate_slow(class_idx, bin);
+  }
+
+  [[gnu::hot]] void deallocate(void* ptr, size_t size) noexcept {
+    if (ptr == nullptr) [[unlikely]]
+      return;
+
+    if (internal::SizeClass::is_large(size)) [[unlikely]] {
+      deallocate_large(ptr, size);
+      return;
+    }
+
+    size_t class_idx = internal::SizeClass::index(size);
+    auto& bin = bins_[class_idx];
+    void* slab_base = internal::slab_base_from_ptr(ptr);
+
+    // Fast path: deallocate to current slab (this is the only code that gets inlined)
+    if (bin.current_slab.valid() && bin.current_slab.base() == slab_base) [[likely]] {
+      bin.current_slab.deallocate(ptr);
+      return;
+    }
+
+    // Slow path: pointer belongs to partial or full slab - not inlined to reduce code size and keep
+    // hot code in the I-cache
+    deallocate_slow(ptr, slab_base, bin);
+  }
+
+  [[nodiscard]] void* allocate(size_t size, flags::isolated_t) noexcept {
+    return allocate(isolated_size(size));
+  }
+
+  void deallocate(void* ptr, size_t size, flags::isolated_t) noexcept {
+    deallocate(ptr, isolated_size(size));
+  }
+
+  // Allocate `n` blocks of `size` bytes into `out`. The size class is resolved once and blocks
+  // are taken from each slab as whole runs. Returns the number of blocks allocated, which is
+  // less than `n` only if memory ran out.
+  [[nodiscard]] size_t allocate_batch(size_t size, void** out, size_t n) noexcept {
+    if (internal::SizeClass::is_large(size)) [[unlikely]] {
+      size_t count = 0;
+      while (count < n && (out[count] = allocate_large(size)) != nullptr) ++count;
+      return count;
+    }
+
+    const size_t class_idx = internal::SizeClass::index(size);
+    auto& bin = bins_[class_idx];
+    size_t count = 0;
+    while (count < n) {
+      count += bin.current_slab.allocate_batch(out + count, n - count);
+      if (count == n) break;
+
+      // Current slab exhausted: rotate in the next one, which also serves one block
+      void* ptr = allocate_slow(class_idx, bin);
+      if (ptr == nullptr) [[unlikely]] break;
+      out[count++] = ptr;
+    }
+    return count;
+  }
+
+  // Free `n` blocks of `size` bytes. Consecutive pointers from the same slab are returned as one
+  // run, so batches freed in allocation order cost one free-list splice per slab.
+  void deallocate_batch(void* const* ptrs, size_t n, size_t size) noexcept {
+    if (internal::SizeClass::is_large(size)) [[unlikely]] {
+      for (size_t i = 0; i < n; ++i) {
+        if (ptrs[i] != nullptr) deallocate_large(ptrs[i], size);
+      }
+      return;
+    }
+
+    auto& bin = bins_[internal::SizeClass::index(size)];
+    size_t i = 0;
+    while (i < n) {
+      if (ptrs[i] == nullptr) [[unlikely]] {
+        ++i;
+        continue;
+      }
+
+      void* slab_base = internal::slab_base_from_ptr(ptrs[i]);
+      size_t run = 1;
+      while (i + run < n && ptrs[i + run] != nullptr &&
+             internal::slab_base_from_ptr(ptrs[i + run]) == slab_base) {
+        ++run;
+      }
+
+      if (bin.current_slab.valid() && bin.current_slab.base() == slab_base) [[likely]] {
+        bin.current_slab.deallocate_batch(ptrs + i, run);
+      } else {
+        deallocate_run_slow(ptrs + i, run, slab_base, bin);
+      }
+      i += run;
+    }
+  }
+
+  // Bit i selects size class i (see SizeClass::index)
+  using ClassMask = uint32_t;
+  static_assert(internal::SizeClass::kNumClasses <= sizeof(ClassMask) * 8);
+  static constexpr ClassMask kAllClasses = (ClassMask{1} << internal::SizeClass::kNumClasses) - 1;
+
+  // Prefill the selected size classes so that at least `blocks_per_class` blocks of each can be
+  // served without leaving the fast path: slabs are acquired up front, their free lists built and
+  // their pages touched. Meant to be called once per worker thread during startup.
+  // Returns false if memory ran out before every class was filled.
+  bool warmup(ClassMask class_mask, size_t blocks_per_class = 1) noexcept {
+    bool ok = true;
+    for (size_t class_idx = 0; class_idx < internal::SizeClass::kNumClasses; ++class_idx) {
+      if ((class_mask & (ClassMask{1} << class_idx)) != 0) {
+        ok &= warmup_class(class_idx, blocks_per_class);
+      }
+    }
+    return ok;
+  }
+
+  // Same as above for the size classes serving the given allocation sizes
+  bool warmup(std::span<const size_t> sizes, size_t blocks_per_class = 1) noexcept {
+    ClassMask class_mask = 0;
+    for (size_t size : sizes) {
+      if (!internal::SizeClass::is_large(size)) {
+        class_mask |= ClassMask{1} << internal::SizeClass::index(size);
+      }
+    }
+    return warmup(class_mask, blocks_per_class);
+  }
+
+  // Empty slabs this heap keeps per size class before handing their chunks back to the global
+  // pool. Defaults to NEXUSALLOC_CONF's thread_cache_slabs (1): slabs that drain while refills
+  // favour fuller ones go back, and one per class stays warm.
+  void set_empty_slab_limit(size_t limit) noexcept { empty_slab_limit_ = limit; }
+  [[nodiscard]] size_t empty_slab_limit() const noexcept { return empty_slab_limit_; }
+
+  // Slab bytes this heap keeps for itself. While it holds more, slabs that become empty go to
+  // central_cache() for other threads to reuse instead of staying in this heap's bins. Partial
+  // slabs never leave: their blocks must be freed back into this heap. Large allocations do not
+  // count. Defaults to NEXUSALLOC_CONF's thread_cache_bytes (unlimited).
+  void set_byte_budget(size_t bytes) noexcept { byte_budget_ = bytes; }
+  [[nodiscard]] size_t byte_budget() const noexcept { return byte_budget_; }
+
+  void set_slab_selection(SlabSelection selection) noexcept { slab_selection_ = selection; }
+  [[nodiscard]] SlabSelection slab_selection() const noexcept { return slab_selection_; }
+
+  // Free every block in O(chunks): all slab chunks go back to the pool in one batch and tracked
+  // large allocations are unmapped. The heap stays usable.
+  void destroy() noexcept {
+    void* first = nullptr;
+    void* last = nullptr;
+    size_t count = 0;
+    auto collect = [&](const internal::SlabWrapper& slab) {
+      void* chunk = slab.base();
+      if (chunk == nullptr) return;
+      *static_cast<void**>(chunk) = first;  // Link through the first word, as AtomicStack does
+      if (last == nullptr) last = chunk;
+      first = chunk;
+      ++count;
+    };
+
+    for (auto& bin : bins_) {
+      collect(bin.current_slab);
+      bin.partial_slabs.for_each(collect);
+      for (const auto& slab : bin.full_slabs) collect(slab);
+      bin.current_slab = internal::SlabWrapper{};
+      bin.partial_slabs.clear();
+      bin.full_slabs.clear();
+    }
+    if (count > 0) {
+      return_chunks(first, last, count);
+    }
+
+    for (const auto& [ptr, size] : large_) {
+      HugepageProvider::deallocate_large(ptr, size);
+    }
+    large_.clear();
+    large_bytes_ = 0;
+  }
+
+  // Call `fn(ptr, size)` for every live block: slab blocks with their class's block size, then
+  // tracked large allocations with their mapping size. Slabs are walked through their occupancy,
+  // so the cost grows with slabs and live blocks, not with free capacity, and nothing is
+  // allocated. `fn` must not allocate from or free to this heap.
+  template <typename Fn>
+  void for_each_live_block(Fn&& fn) const {
+    for (size_t class_idx = 0; class_idx < internal::SizeClass::kNumClasses; ++class_idx) {
+      const size_t block_size = internal::SizeClass::block_size(class_idx);
+      auto walk = [&](const internal::SlabWrapper& slab) {
+        slab.for_each_live_block([&](void* block) { fn(block, block_size); });
+      };
+      const auto& bin = bins_[class_idx];
+      walk(bin.current_slab);
+      bin.partial_slabs.for_each(walk);
+      for (const auto& slab : bin.full_slabs) walk(slab);
+    }
+    for (const auto& [ptr, size] : large_) {
+      fn(ptr, size);
+    }
+  }
+
+  // Same for the large allocations of heaps that leave them to the shared registry (thread
+  // arenas), across all such heaps. Only allocations made while track_shared_large() was on are
+  // recorded. `fn` runs under the registry's lock.
+  template <typename Fn>
+  static void for_each_shared_large_block(Fn&& fn) {
+    SharedLarge& shared = shared_large();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (const auto& [ptr, size] : shared.blocks) {
+      fn(ptr, size);
+    }
+  }
+
+  // Whether thread arenas record their large allocations for for_each_shared_large_block(). Off
+  // unless NEXUSALLOC_CONF has track_large:true, since each record and erase takes a process-wide
+  // lock and may allocate. Blocks recorded before it is turned off are still erased when freed.
+  static void set_track_shared_large(bool enabled) noexcept {
+    track_shared_large_.store(enabled ? 1 : 0, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static bool track_shared_large() noexcept {
+    const uint8_t value = track_shared_large_.load(std::memory_order_relaxed);
+    return value == kUnsetTracking ? config().track_large : value != 0;
+  }
+
+  // Slab chunks currently held
+  [[nodiscard]] size_t chunk_count() const noexcept {
+    size_t count = 0;
+    for (const auto& bin : bins_) {
+      count += (bin.current_slab.valid() ? 1 : 0) + bin.partial_slabs.size() +
+               bin.full_slabs.size();
+    }
+    return count;
+  }
+
+  // Memory held by this heap: its slab chunks plus tracked large allocations
+  [[nodiscard]] size_t mapped_bytes() const noexcept {
+    return chunk_count() * PageTraits::kChunkSize + large_bytes_;
+  }
+
+  // Take a chunk from the global pool or the OS. Also used by the chunk-backed pmr resources.
+  [[nodiscard]] static void* request_chunk() noexcept {
+    AtomicStack& pool = global_page_stack();
+    void* chunk = pool.pop();
+    if (chunk != nullptr) [[likely]] {
+      ChunkRefiller::notify_low(pool.approximate_size());
+      return chunk;
+    }
+
+    // Pool ran dry: wake the refill thread (if any) and map this chunk synchronously
+    ChunkRefiller::notify_low(0);
+
+    return HugepageProvider::allocate_chunk();
+  }
+
+  // With decay_ms:0 chunks go straight back to the OS instead of the pool
+  static void return_chunk(void* chunk) noexcept {
+    if (chunk == nullptr) return;
+    if (config().decay_ms == 0) {
+      HugepageProvider::deallocate_chunk(chunk);
+    } else {
+      global_page_stack().push(chunk);
+    }
+  }
+
+  // Return `count` chunks linked through their first word (see AtomicStack::push_chain) in one
+  // batch
+  static void return_chunks(void* first, void* last, size_t count) noexcept {
+    if (config().decay_ms == 0) {
+      for (size_t i = 0; i < count; ++i) {
+        void* next = *static_cast<void**>(first);
+        HugepageProvider::deallocate_chunk(first);
+        first = next;
+      }
+    } else {
+      global_page_stack().push_chain(first, last, count);
+    }
+  }
+
+ private:
+  struct alignas(internal::kCacheLineSize) SizeClassBin {
+    internal::SlabWrapper current_slab{};
+    internal::PartialSlabs partial_slabs;
+    std::vector<internal::SlabWrapper> full_slabs;
+  };
+  std::array<SizeClassBin, internal::SizeClass::kNumClasses> bins_;
+  size_t empty_slab_limit_{config().thread_cache_slabs};
+  size_t byte_budget_{config().thread_cache_bytes};
+  SlabSelection slab_selection_{SlabSelection::kFullest};
+
+  // Spreads heaps over the central cache's shards
+  [[nodiscard]] size_t central_shard() const noexcept {
+    return reinterpret_cast<uintptr_t>(this) / sizeof(Heap);
+  }
+
+  // Slab blocks of a cache-line multiple start on a line (chunks are aligned and slab colors are
+  // whole lines), and large allocations on a page, so rounding the size is enough
+  [[nodiscard]] static constexpr size_t isolated_size(size_t size) noexcept {
+    if (internal::SizeClass::is_large(size)) return size;
+    return internal::align_up(std::max(size, size_t{1}), internal::kCacheLineSize);
+  }
+
+  [[nodiscard, gnu::noinline, gnu::cold]]
+  void* allocate_slow(size_t class_idx, SizeClassBin& bin) noexcept {
+    // Move current slab to full list if it exists and is full
+    if (bin.current_slab.valid()) {
+      bin.full_slabs.push_back(std::move(bin.current_slab));
+      bin.current_slab = internal::SlabWrapper{};
+    }
+
+    // Try partial slabs
+    if (!bin.partial_slabs.empty()) {
+      bin.current_slab = slab_selection_ == SlabSelection::kFullest
+                             ? bin.partial_slabs.take_fullest()
+                             : bin.partial_slabs.take_newest();
+      return bin.current_slab.allocate();
+    }
+
+    // An empty slab some other heap gave up
+    internal::SlabWrapper cached = central_cache().pop(class_idx, central_shard());
+    if (cached.valid()) {
+      bin.current_slab = std::move(cached);
+      return bin.current_slab.allocate();
+    }
+
+    // Need a new chunk
+    void* chunk = request_chunk();
+    if (chunk == nullptr) {
+      return nullptr;  // Out of memory
+    }
+
+    // Create new slab for this size class using compile-time dispatch
+    bin.current_slab = internal::SlabWrapper(class_idx, chunk);
+    return bin.current_slab.allocate();
+  }
+
+  bool warmup_class(size_t class_idx, size_t blocks) noexcept {
+    auto& bin = bins_[class_idx];
+
+    // A full current slab would send the first allocation down the slow path
+    if (bin.current_slab.valid() && bin.current_slab.full()) {
+      bin.full_slabs.push_back(std::move(bin.current_slab));
+      bin.current_slab = internal::SlabWrapper{};
+    }
+    if (!bin.current_slab.valid() && !bin.partial_slabs.empty()) {
+      bin.current_slab = bin.partial_slabs.take_fullest();
+    }
+
+    size_t available = bin.current_slab.free_blocks();
+    bin.partial_slabs.for_each([&](const auto& slab) { available += slab.free_blocks(); });
+
+    while (!bin.current_slab.valid() || available < blocks) {
+      internal::SlabWrapper slab = central_cache().pop(class_idx, central_shard());
+      if (!slab.valid()) {
+        void* chunk = request_chunk();
+        if (chunk == nullptr) {
+          return false;  // Out of memory
+        }
+        slab = internal::SlabWrapper(class_idx, chunk);
+      }
+
+      // Fault the chunk in now, whatever the populate policy, so warmed blocks never page-fault
+      HugepageProvider::populate(slab.base(), PageTraits::kChunkSize);
+      available += slab.free_blocks();
+      if (!bin.current_slab.valid()) {
+        bin.current_slab = std::move(slab);
+      } else {
+        bin.partial_slabs.push(std::move(slab));
+      }
+    }
+
+    return true;
+  }
+
+  [[gnu::noinline, gnu::cold]]
+  void deallocate_slow(void* ptr, void* slab_base, SizeClassBin& bin) noexcept {
+    // Search partial slabs
+    internal::PartialSlabs::Position pos{};
+    if (internal::SlabWrapper* slab = bin.partial_slabs.find(slab_base, pos)) {
+      slab->deallocate(ptr);
+      if (!slab->empty() || !release_empty_slab(bin, pos)) {
+        bin.partial_slabs.update(pos);
+      }
+      return;
+    }
+
+    // Search full slabs
+    for (size_t i = 0; i < bin.full_slabs.size(); ++i) {
+      if (bin.full_slabs[i].base() == slab_base) {
+        bin.full_slabs[i].deallocate(ptr);
+        // Move to partial list since it now has free blocks
+        bin.partial_slabs.push(std::move(bin.full_slabs[i]));
+        bin.full_slabs.erase(bin.full_slabs.begin() + static_cast<ptrdiff_t>(i));
+        return;
+      }
+    }
+
+    // Pointer not found - undefined behavior, silently ignore
+  }
+
+  [[gnu::noinline, gnu::cold]]
+  void deallocate_run_slow(void* const* ptrs, size_t n, void* slab_base,
+                           SizeClassBin& bin) noexcept {
+    internal::PartialSlabs::Position pos{};
+    if (internal::SlabWrapper* slab = bin.partial_slabs.find(slab_base, pos)) {
+      slab->deallocate_batch(ptrs, n);
+      if (!slab->empty() || !release_empty_slab(bin, pos)) {
+        bin.partial_slabs.update(pos);
+      }
+      return;
+    }
+
+    for (size_t i = 0; i < bin.full_slabs.size(); ++i) {
+      if (bin.full_slabs[i].base() == slab_base) {
+        bin.full_slabs[i].deallocate_batch(ptrs, n);
+        bin.partial_slabs.push(std::move(bin.full_slabs[i]));
+        bin.full_slabs.erase(bin.full_slabs.begin() + static_cast<ptrdiff_t>(i));
+        return;
+      }
+    }
+
+    // Pointers not found - undefined behavior, silently ignore
+  }
+
+  // The partial slab at `pos` just became empty: over budget it goes to the central cache,
+  // otherwise the per-class empty slab limit applies. Returns whether it left the bin.
+  bool release_empty_slab(SizeClassBin& bin, internal::PartialSlabs::Position pos) noexcept {
+    if (byte_budget_ != Config::kUnlimited &&
+        chunk_count() * PageTraits::kChunkSize > byte_budget_) {
+      internal::SlabWrapper slab = bin.partial_slabs.remove(pos);
+      // decay_ms:0 asks for memory back at once, so the chunk is not parked in the cache either
+      if (config().decay_ms == 0 || !central_cache().push(slab, central_shard())) {
+        return_chunk(slab.base());
+      }
+      return true;
+    }
+    return empty_slab_limit_ != Config::kUnlimited && trim_empty_slab(bin, pos);
+  }
+
+  // Release the partial slab at `pos`, which just became empty, if the bin already holds as many
+  // empty slabs as the limit allows. Returns whether it was released.
+  bool trim_empty_slab(SizeClassBin& bin, internal::PartialSlabs::Position pos) noexcept {
+    // The slab may still sit in a higher bucket, so it is counted separately
+    const size_t empty_slabs = bin.partial_slabs.count_empty() + (pos.bucket != 0 ? 1 : 0);
+    if (empty_slabs <= empty_slab_limit_) return false;
+
+    return_chunk(bin.partial_slabs.remove(pos).base());
+    return true;
+  }
+
+  [[nodiscard]] void* allocate_large(size_t size) noexcept {
+    size_t aligned_size = internal::align_up(size, PageTraits::kRegularPageSize);
+    void* ptr = HugepageProvider::allocate_large(aligned_size);
+    if (ptr != nullptr && !record_large(ptr, aligned_size)) {
+      HugepageProvider::deallocate_large(ptr, aligned_size);
+      return nullptr;
+    }
+    return ptr;
+  }
+
+  void deallocate_large(void* ptr, size_t size) noexcept {
+    size_t aligned_size = internal::align_up(size, PageTraits::kRegularPageSize);
+    if (track_large_) {
+      if (large_.erase(ptr) != 0) large_bytes_ -= aligned_size;
+    } else if (shared_large_count_.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+      SharedLarge& shared = shared_large();
+      std::lock_guard<std::mutex> lock(shared.mutex);
+      if (shared.blocks.erase(ptr) != 0) {
+        shared_large_count_.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+    HugepageProvider::deallocate_large(ptr, aligned_size);
+  }
+
+  // Returns false if bookkeeping memory ran out
+  bool record_large(void* ptr, size_t size) noexcept {
+    try {
+      if (track_large_) {
+        large_.emplace(ptr, size);
+        large_bytes_ += size;
+      } else if (track_shared_large()) [[unlikely]] {
+        SharedLarge& shared = shared_large();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (shared.blocks.emplace(ptr, size).second) {
+          shared_large_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    } catch (...) {
+      return false;
+    }
+    return true;
+  }
+
+  // Large allocations of heaps built with SharedLargeTag, which any thread may free. Only kept
+  // while track_shared_large() is on.
+  struct SharedLarge {
+    std::mutex mutex;
+    std::unordered_map<void*, size_t> blocks;
+  };
+
+  static constexpr uint8_t kUnsetTracking = 0xFF;  // NEXUSALLOC_CONF's track_large applies
+  static inline std::atomic<uint8_t> track_shared_large_{kUnsetTracking};
+  // Size of the registry, so frees skip its lock while it is empty
+  static inline std::atomic<size_t> shared_large_count_{0};
+
+  // Never destroyed, so threads exiting during static destruction can still free into it
+  [[nodiscard]] static SharedLarge& shared_large() noexcept {
+    alignas(SharedLarge) static unsigned char storage[sizeof(SharedLarge)];
+    static SharedLarge* shared = new (storage) SharedLarge;
+    return *shared;
+  }
+
+  // Large allocations of a standalone heap are tracked so destroy() can unmap them
+  std::unordered_map<void*, size_t> large_;
+  size_t large_bytes_{0};
+  bool track_large_{true};
+
+ protected:
+  // ThreadArena leaves large allocations to the shared registry (see set_track_shared_large())
+  // instead of its own map: they may be freed from another thread or after the thread exits, and
+  // destroy() leaves them alone
+  struct SharedLargeTag {};
+  explicit Heap(SharedLargeTag) noexcept : track_large_(false) {}
+};
+
+}  // namespace nexusalloc
@@ -3,8 +3,21 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#include "nexusalloc/atomic_stack.hpp"
+#include "nexusalloc/config.hpp"
+#include "nexusalloc/internal/alignment.hpp"
+#include "nexusalloc/internal/cgroup.hpp"
+#include "nexusalloc/internal/hugepage_probe.hpp"
+#include "nexusalloc/internal/numa.hpp"
 
 namespace nexusalloc {
 
@@ -12,33 +25,344 @@ struct PageTraits {
   static constexpr size_t kHugePageSize = 2 * 1024 * 1024;  // 2MB
   static constexpr size_t kRegularPageSize = 4096;          // 4KB
   static constexpr size_t kChunkSize = kHugePageSize;       // Default chunk size
+  static constexpr size_t kGiganticPageSize = 1024 * 1024 * 1024;  // 1GB
+  static constexpr size_t kChunksPerGiganticPage = kGiganticPageSize / kChunkSize;
+};
+
+// Snapshot of the memory the provider currently has mapped from the OS
+struct ProviderStats {
+  size_t chunks_mapped{0};       // Chunks currently mapped (pooled or owned by slabs)
+  size_t large_allocations{0};   // Live direct-mmap allocations (> SizeClass::kMaxSlabSize)
+  size_t large_bytes{0};         // Bytes mapped for those allocations
+  size_t large_cached_bytes{0};  // Freed large mappings kept for reuse
+  size_t gigantic_regions{0};    // 1GB super-regions mapped in PageMode::kHugetlb1G
+  size_t hugetlb_failures{0};    // MAP_HUGETLB mappings the kernel refused
+  size_t limit_failures{0};      // Mappings refused at the hard memory limit
+  size_t pressure_events{0};     // Times mapped bytes crossed the soft memory limit
+  std::array<size_t, kPageModeCount> chunks_by_backing{};  // Mapped chunks per sourcing strategy
+
+  [[nodiscard]] size_t mapped_bytes() const noexcept {
+    return chunks_mapped * PageTraits::kChunkSize + large_bytes + large_cached_bytes;
+  }
+
+  [[nodiscard]] size_t chunks_backed_by(PageMode mode) const noexcept {
+    return chunks_by_backing[static_cast<size_t>(mode)];
+  }
 };
 
+namespace internal {
+
+// Bump cursor into the current 1GB super-region, swapped with a 128-bit CAS like AtomicStack's head
+struct GiganticCursor {
+  char* base{nullptr};
+  uint64_t next{0};  // Index of the next chunk to hand out
+};
+
+// One byte per 2MB chunk of the 47-bit user address space, recording how each chunk is backed
+// without going through any allocator. Two-level radix: the root lives in static storage and
+// 8KB leaves (16GB of address space each) are mmapped on first use and never released.
+class ChunkMap {
+ public:
+  constexpr ChunkMap() noexcept = default;
+
+  void set(const void* chunk, uint8_t value) noexcept {
+    const uintptr_t index = chunk_index(chunk);
+    if (index >= kEntries) return;
+    uint8_t* leaf = leaf_for(index >> kLeafBits);
+    if (leaf == nullptr) return;
+    std::atomic_ref<uint8_t>(leaf[index & (kLeafSize - 1)]).store(value, std::memory_order_relaxed);
+  }
+
+  // 0 for chunks that were never recorded
+  [[nodiscard]] uint8_t get(const void* chunk) const noexcept {
+    const uintptr_t index = chunk_index(chunk);
+    if (index >= kEntries) return 0;
+    uint8_t* leaf = root_[index >> kLeafBits].load(std::memory_order_acquire);
+    if (leaf == nullptr) return 0;
+    return std::atomic_ref<uint8_t>(leaf[index & (kLeafSize - 1)]).load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kEntries = (uintptr_t{1} << 47) / PageTraits::kChunkSize;
+  static constexpr size_t kLeafBits = 13;
+  static constexpr size_t kLeafSize = size_t{1} << kLeafBits;
+  static constexpr size_t kRootSize = kEntries / kLeafSize;
+
+  [[nodiscard]] static uintptr_t chunk_index(const void* chunk) noexcept {
+    return reinterpret_cast<uintptr_t>(chunk) / PageTraits::kChunkSize;
+  }
+
+  uint8_t* leaf_for(size_t root_index) noexcept {
+    uint8_t* leaf = root_[root_index].load(std::memory_order_acquire);
+    if (leaf != nullptr) [[likely]] {
+      return leaf;
+    }
+
+    void* fresh =
+        mmap(nullptr, kLeafSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (fresh == MAP_FAILED) return nullptr;
+    if (root_[root_index].compare_exchange_strong(leaf, static_cast<uint8_t*>(fresh),
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+      return static_cast<uint8_t*>(fresh);
+    }
+    munmap(fresh, kLeafSize);  // Another thread installed this leaf first
+    return leaf;
+  }
+
+  std::atomic<uint8_t*> root_[kRootSize]{};
+};
+
+}  // namespace internal
+
 class HugepageProvider {
  public:
   HugepageProvider() = delete;
 
+  static void set_page_mode(PageMode mode) noexcept {
+    page_mode_.store(static_cast<uint8_t>(mode), std::memory_order_relaxed);
+  }
+
+  // Until set explicitly, NEXUSALLOC_CONF's page_mode
+  [[nodiscard]] static PageMode page_mode() noexcept {
+    const uint8_t value = page_mode_.load(std::memory_order_relaxed);
+    return value == kUnset ? config().page_mode : static_cast<PageMode>(value);
+  }
+
+  static void set_populate_policy(PopulatePolicy policy) noexcept {
+    populate_policy_.store(static_cast<uint8_t>(policy), std::memory_order_relaxed);
+  }
+
+  // Until set explicitly, NEXUSALLOC_CONF's populate policy
+  [[nodiscard]] static PopulatePolicy populate_policy() noexcept {
+    const uint8_t value = populate_policy_.load(std::memory_order_relaxed);
+    return value == kUnset ? config().populate : static_cast<PopulatePolicy>(value);
+  }
+
+  // Freed large allocations up to this many bytes in total are kept mapped and handed back out
+  // for the next allocation of exactly the same size, saving the munmap/mmap pair and the page
+  // faults. 0 disables the cache, Config::kUnlimited lifts the cap. Until set explicitly,
+  // NEXUSALLOC_CONF's large_cache.
+  static void set_large_cache_limit(size_t bytes) noexcept {
+    large_cache_limit_.store(bytes, std::memory_order_relaxed);
+    if (bytes == 0) trim_large_cache();
+  }
+
+  [[nodiscard]] static size_t large_cache_limit() noexcept {
+    return resolve_limit(large_cache_limit_.load(std::memory_order_relaxed),
+                         config().large_cache_bytes);
+  }
+
+  // Unmap every cached large allocation
+  static void trim_large_cache() noexcept {
+    LargeCache& cache = large_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    for (size_t i = 0; i < cache.count; ++i) {
+      munmap(cache.entries[i].ptr, cache.entries[i].size);
+    }
+    cache.count = 0;
+    large_cached_bytes_.store(0, std::memory_order_relaxed);
+  }
+
+  // Limits on mapped bytes (ProviderStats::mapped_bytes()). Crossing the soft limit purges cached
+  // memory (see purge()) and then runs the pressure callback. A chunk or large mapping that would
+  // take the total past the hard limit is refused after one purge: allocate() returns nullptr
+  // without calling mmap. Concurrent mappings can overshoot by a mapping per thread. Each limit
+  // is a byte count, Config::kUnlimited, or Config::kFromCgroup; until set explicitly,
+  // NEXUSALLOC_CONF's soft_limit and hard_limit apply.
+  static void set_memory_limits(size_t soft, size_t hard) noexcept {
+    soft_limit_.store(soft, std::memory_order_relaxed);
+    hard_limit_.store(hard, std::memory_order_relaxed);
+    under_pressure_.store(false, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static size_t soft_limit() noexcept {
+    const size_t value = resolve_limit(soft_limit_.load(std::memory_order_relaxed),
+                                       config().soft_limit);
+    return value == Config::kFromCgroup ? cgroup_limits().soft : value;
+  }
+
+  [[nodiscard]] static size_t hard_limit() noexcept {
+    const size_t value = resolve_limit(hard_limit_.load(std::memory_order_relaxed),
+                                       config().hard_limit);
+    return value == Config::kFromCgroup ? cgroup_limits().hard : value;
+  }
+
+  // Whether mapped bytes were above the soft limit at the last mapping
+  [[nodiscard]] static bool under_pressure() noexcept {
+    return under_pressure_.load(std::memory_order_relaxed);
+  }
+
+  // Runs on the allocating thread each time mapped bytes cross the soft limit upwards, after the
+  // purge, with the bytes still mapped. It must not allocate through nexusalloc. nullptr clears.
+  using PressureCallback = void (*)(size_t mapped_bytes, void* context);
+  static void set_pressure_callback(PressureCallback callback, void* context = nullptr) noexcept {
+    PressureHandler& handler = pressure_handler();
+    std::lock_guard<std::mutex> lock(handler.mutex);
+    handler.callback = callback;
+    handler.context = context;
+  }
+
+  // Lets a cache layered above the provider (central_cache()) unmap what it holds during purge()
+  static void set_cache_purger(void (*purger)()) noexcept {
+    cache_purger_.store(purger, std::memory_order_release);
+  }
+
+  // Give cached memory back to the OS: the registered cache's chunks, every chunk pooled in
+  // global_page_stack() and all cached large mappings. Returns the number of bytes unmapped.
+  static size_t purge() noexcept {
+    const size_t before = current_mapped_bytes();
+    if (void (*purger)() = cache_purger_.load(std::memory_order_acquire)) {
+      purger();
+    }
+    AtomicStack& pool = global_page_stack();
+    while (void* chunk = pool.pop()) {
+      deallocate_chunk(chunk);
+    }
+    trim_large_cache();
+    const size_t after = current_mapped_bytes();
+    return before > after ? before - after : 0;
+  }
+
+  // Ask the kernel to collapse freshly faulted THP chunks into a huge page synchronously
+  // (MADV_COLLAPSE, Linux 6.1+) when the fault path fell back to 4KB pages. Ignored by older
+  // kernels.
+  static void set_thp_collapse(bool enabled) noexcept {
+    thp_collapse_.store(enabled, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static bool thp_collapse() noexcept {
+    return thp_collapse_.load(std::memory_order_relaxed);
+  }
+
+  // Re-read hugetlb pool counters and the THP setting from sysfs and enable or disable the
+  // matching strategies. Called by initialize(), and by the provider itself every
+  // kReprobeInterval chunk requests, so a strategy disabled after a failed mapping comes back
+  // once pages are freed or the pool is grown. Unreadable sysfs leaves a strategy enabled.
+  static void probe() noexcept {
+    update_strategy(PageMode::kHugetlb2M, internal::hugetlb_availability(2048));
+    update_strategy(PageMode::kHugetlb1G, internal::hugetlb_availability(1024 * 1024));
+    update_strategy(PageMode::kTransparent, internal::thp_availability());
+  }
+
+  // Whether the provider currently attempts `mode` as a chunk source. kRegular always is.
+  [[nodiscard]] static bool strategy_available(PageMode mode) noexcept {
+    return (unavailable_mask_.load(std::memory_order_relaxed) & strategy_bit(mode)) == 0;
+  }
+
+  // Strategy that sourced `chunk`; kRegular for pointers the provider did not map
+  [[nodiscard]] static PageMode chunk_backing(const void* chunk) noexcept {
+    const uint8_t entry = chunk_map_.get(chunk);
+    return entry == 0 ? PageMode::kRegular : static_cast<PageMode>(entry - 1);
+  }
+
+  // Pages are faulted in according to populate_policy()
   [[nodiscard]] static void* allocate_chunk() noexcept {
-    void* ptr = nullptr;
+    return map_chunk(populate_policy() == PopulatePolicy::kEager ? MAP_POPULATE : 0);
+  }
 
-#ifdef NEXUSALLOC_USE_HUGEPAGES
-    ptr = mmap(nullptr, PageTraits::kChunkSize, PROT_READ | PROT_WRITE,
-               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+  // Map a chunk with every page faulted in regardless of the populate policy, for startup
+  // reservation
+  [[nodiscard]] static void* allocate_populated_chunk() noexcept { return map_chunk(MAP_POPULATE); }
 
-    if (ptr == MAP_FAILED) [[unlikely]] {
-      ptr = allocate_regular_chunk();
+  // Populated chunk for the refill thread. Returns nullptr rather than take mapped bytes past the
+  // soft limit, so the purge and the pressure callback only ever run on allocating threads.
+  [[nodiscard]] static void* allocate_refill_chunk() noexcept {
+    const size_t soft = soft_limit();
+    if (soft != Config::kUnlimited &&
+        (current_mapped_bytes() > soft || soft - current_mapped_bytes() < PageTraits::kChunkSize)) {
+      return nullptr;
     }
-#else
-    ptr = allocate_regular_chunk();
-#endif
+    if (!admit(PageTraits::kChunkSize)) [[unlikely]] {
+      return nullptr;
+    }
+    return map_chunk_unchecked(MAP_POPULATE);
+  }
 
+  // Map a chunk whose pages prefer NUMA `node`, fully faulted in before it is returned. Intended
+  // for startup reservation: the policy has to be set before the first touch, so this maps
+  // without MAP_POPULATE and pre-faults by hand. Chunks carved from 1GB super-regions keep the
+  // placement of their region.
+  [[nodiscard]] static void* allocate_chunk_on_node(int node) noexcept {
+    void* ptr = map_chunk(0);
+    if (ptr == nullptr) [[unlikely]] {
+      return nullptr;
+    }
+    internal::numa_prefer_node(ptr, PageTraits::kChunkSize, node);
+    prefault(ptr, PageTraits::kChunkSize);
     return ptr;
   }
 
+  // Chunks carved from a 1GB super-region cannot be unmapped individually, so they are kept for
+  // reuse by the next allocate_chunk() instead. Any chunk may once have been linked into
+  // global_page_stack(), so pops still reading it are waited out before the unmap.
   static void deallocate_chunk(void* ptr) noexcept {
-    if (ptr != nullptr && ptr != MAP_FAILED) [[likely]] {
-      munmap(ptr, PageTraits::kChunkSize);
+    if (ptr == nullptr || ptr == MAP_FAILED) [[unlikely]] {
+      return;
+    }
+    if (in_gigantic_region(ptr)) {
+      gigantic_free_chunks().push(ptr);
+      return;
     }
+    global_page_stack().quiesce();
+    munmap(ptr, PageTraits::kChunkSize);
+    if (const uint8_t entry = chunk_map_.get(ptr); entry != 0) {
+      chunks_by_backing_[entry - 1].fetch_sub(1, std::memory_order_relaxed);
+      chunk_map_.set(ptr, 0);
+    }
+    chunks_mapped_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // Direct mapping for allocations too large for any slab. `size` must already be page aligned.
+  [[nodiscard]] static void* allocate_large(size_t size) noexcept {
+    void* ptr = take_cached_large(size);
+    if (ptr == nullptr) {
+      if (!admit(size)) [[unlikely]] {
+        return nullptr;
+      }
+      ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (ptr == MAP_FAILED) {
+        return nullptr;
+      }
+    }
+    large_allocations_.fetch_add(1, std::memory_order_relaxed);
+    large_bytes_.fetch_add(size, std::memory_order_relaxed);
+    check_soft_limit();
+    return ptr;
+  }
+
+  static void deallocate_large(void* ptr, size_t size) noexcept {
+    if (cache_large(ptr, size) || munmap(ptr, size) == 0) {
+      large_allocations_.fetch_sub(1, std::memory_order_relaxed);
+      large_bytes_.fetch_sub(size, std::memory_order_relaxed);
+    }
+  }
+
+  // Fault in [ptr, ptr + size) now, in one syscall where MADV_POPULATE_WRITE is available
+  // (Linux 5.14+)
+  static void populate(void* ptr, size_t size) noexcept {
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(ptr, size, MADV_POPULATE_WRITE) == 0) {
+      return;
+    }
+#endif
+    prefault(ptr, size);
+  }
+
+  [[nodiscard]] static ProviderStats stats() noexcept {
+    ProviderStats result;
+    result.chunks_mapped = chunks_mapped_.load(std::memory_order_relaxed);
+    result.large_allocations = large_allocations_.load(std::memory_order_relaxed);
+    result.large_bytes = large_bytes_.load(std::memory_order_relaxed);
+    result.large_cached_bytes = large_cached_bytes_.load(std::memory_order_relaxed);
+    result.gigantic_regions = gigantic_region_count();
+    result.hugetlb_failures = hugetlb_failures_.load(std::memory_order_relaxed);
+    result.limit_failures = limit_failures_.load(std::memory_order_relaxed);
+    result.pressure_events = pressure_events_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kPageModeCount; ++i) {
+      result.chunks_by_backing[i] = chunks_by_backing_[i].load(std::memory_order_relaxed);
+    }
+    return result;
   }
 
   static bool lock_memory() noexcept {
@@ -62,18 +386,438 @@ class HugepageProvider {
 
   [[nodiscard]] static constexpr size_t chunk_size() noexcept { return PageTraits::kChunkSize; }
 
+  // Bytes of [ptr, ptr + size) currently backed by transparent huge pages, taken from the
+  // AnonHugePages lines of /proc/self/smaps. The kernel reports per VMA and adjacent chunks often
+  // share one, so each VMA's count is clamped to its overlap with the range. Reads procfs: meant
+  // for diagnostics and tests, not the allocation path.
+  [[nodiscard]] static size_t thp_backed_bytes(const void* ptr, size_t size) noexcept {
+    FILE* f = std::fopen("/proc/self/smaps", "r");
+    if (f == nullptr) return 0;
+
+    const uintptr_t lo = reinterpret_cast<uintptr_t>(ptr);
+    const uintptr_t hi = lo + size;
+    uintptr_t overlap = 0;
+    size_t total = 0;
+
+    char line[512];
+    while (std::fgets(line, sizeof(line), f) != nullptr) {
+      unsigned long start = 0;
+      unsigned long end = 0;
+      unsigned long kb = 0;
+      if (std::sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+        overlap = (start < hi && end > lo) ? std::min<uintptr_t>(end, hi) -
+                                                 std::max<uintptr_t>(start, lo)
+                                           : 0;
+      } else if (overlap > 0 && std::sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+        total += std::min<size_t>(static_cast<size_t>(kb) * 1024, overlap);
+      }
+    }
+    std::fclose(f);
+    return total;
+  }
+
  private:
-  [[nodiscard]] static void* allocate_regular_chunk() noexcept {
-    void* ptr = mmap(nullptr, PageTraits::kChunkSize, PROT_READ | PROT_WRITE,
-                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+  // 1GB super-regions are tracked in a fixed table so carved chunks can be recognised on
+  // deallocation without any allocation. Beyond this many regions (1TB), chunks fall back to 2MB.
+  static constexpr size_t kMaxGiganticRegions = 1024;
+  static constexpr int kMapHuge1GB = 30 << MAP_HUGE_SHIFT;
+  static constexpr size_t kReprobeInterval = 256;
+  static constexpr uint8_t kUnset = 0xFF;  // Setting not overridden, NEXUSALLOC_CONF applies
+  static constexpr size_t kLargeCacheSlots = 64;
 
-    if (ptr == MAP_FAILED) {
+  struct LargeCache {
+    struct Entry {
+      void* ptr;
+      size_t size;
+    };
+    std::mutex mutex;
+    Entry entries[kLargeCacheSlots];
+    size_t count{0};
+  };
+#ifdef MADV_COLLAPSE
+  static constexpr int kMadvCollapse = MADV_COLLAPSE;
+#else
+  static constexpr int kMadvCollapse = 25;  // From <asm-generic/mman-common.h>, Linux 6.1+
+#endif
+
+  [[nodiscard]] static void* map_chunk(int populate_flag) noexcept {
+    if (!admit(PageTraits::kChunkSize)) [[unlikely]] {
       return nullptr;
     }
+    void* chunk = map_chunk_unchecked(populate_flag);
+    if (chunk != nullptr) [[likely]] {
+      check_soft_limit();
+    }
+    return chunk;
+  }
+
+  [[nodiscard]] static void* map_chunk_unchecked(int populate_flag) noexcept {
+    const size_t request = chunk_requests_.fetch_add(1, std::memory_order_relaxed);
+    if (request % kReprobeInterval == 0) [[unlikely]] {
+      if (request == 0 && config().stats) {
+        std::atexit(print_exit_stats);
+      }
+      probe();
+    }
+
+    const PageMode mode = page_mode();
+    void* ptr = nullptr;
+
+#ifdef NEXUSALLOC_USE_HUGEPAGES
+    if (mode == PageMode::kHugetlb1G) {
+      ptr = allocate_gigantic_chunk(populate_flag);
+      if (ptr != nullptr) {
+        return ptr;
+      }
+    }
+
+    if ((mode == PageMode::kHugetlb2M || mode == PageMode::kHugetlb1G) &&
+        strategy_available(PageMode::kHugetlb2M)) {
+      ptr = mmap(nullptr, PageTraits::kChunkSize, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate_flag, -1, 0);
+      if (ptr != MAP_FAILED) [[likely]] {
+        record_chunk(ptr, PageMode::kHugetlb2M);
+        return ptr;
+      }
+      record_failure(PageMode::kHugetlb2M);
+    }
+#endif
+
+    const bool transparent =
+        mode != PageMode::kRegular && strategy_available(PageMode::kTransparent);
+    ptr = allocate_regular_chunk(populate_flag, transparent);
+    if (ptr != nullptr) [[likely]] {
+      record_chunk(ptr, transparent ? PageMode::kTransparent : PageMode::kRegular);
+    }
     return ptr;
   }
 
+  static constexpr size_t kUnsetLimit = Config::kUnlimited - 2;  // NEXUSALLOC_CONF applies
+
+  struct ResolvedLimits {
+    size_t soft;
+    size_t hard;
+  };
+
+  [[nodiscard]] static constexpr size_t resolve_limit(size_t value, size_t configured) noexcept {
+    return value == kUnsetLimit ? configured : value;
+  }
+
+  // Read once: memory.high, or 90% of memory.max when only that is set, as the soft limit
+  [[nodiscard]] static const ResolvedLimits& cgroup_limits() noexcept {
+    static const ResolvedLimits limits = [] {
+      const internal::CgroupMemoryLimits cgroup = internal::cgroup_memory_limits();
+      size_t soft = cgroup.high;
+      if (soft == Config::kUnlimited && cgroup.max != Config::kUnlimited) {
+        soft = cgroup.max / 10 * 9;
+      }
+      return ResolvedLimits{soft, cgroup.max};
+    }();
+    return limits;
+  }
+
+  [[nodiscard]] static size_t current_mapped_bytes() noexcept {
+    return chunks_mapped_.load(std::memory_order_relaxed) * PageTraits::kChunkSize +
+           large_bytes_.load(std::memory_order_relaxed) +
+           large_cached_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Whether `bytes` more can be mapped under the hard limit, purging once if not
+  [[nodiscard]] static bool admit(size_t bytes) noexcept {
+    const size_t hard = hard_limit();
+    if (hard == Config::kUnlimited) [[likely]] {
+      return true;
+    }
+    auto fits = [&] {
+      const size_t mapped = current_mapped_bytes();
+      return mapped <= hard && bytes <= hard - mapped;
+    };
+    if (fits()) return true;
+    purge();
+    if (fits()) return true;
+    limit_failures_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Purge and notify once per upward crossing of the soft limit
+  static void check_soft_limit() noexcept {
+    const size_t soft = soft_limit();
+    if (soft == Config::kUnlimited) [[likely]] {
+      return;
+    }
+    if (current_mapped_bytes() <= soft) {
+      under_pressure_.store(false, std::memory_order_relaxed);
+      return;
+    }
+    if (under_pressure_.exchange(true, std::memory_order_relaxed)) {
+      return;
+    }
+    pressure_events_.fetch_add(1, std::memory_order_relaxed);
+    purge();
+
+    PressureHandler& handler = pressure_handler();
+    PressureCallback callback = nullptr;
+    void* context = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(handler.mutex);
+      callback = handler.callback;
+      context = handler.context;
+    }
+    if (callback != nullptr) {
+      callback(current_mapped_bytes(), context);
+    }
+  }
+
+  struct PressureHandler {
+    std::mutex mutex;
+    PressureCallback callback{nullptr};
+    void* context{nullptr};
+  };
+
+  static PressureHandler& pressure_handler() noexcept {
+    static PressureHandler handler;
+    return handler;
+  }
+
+  static void record_chunk(void* chunk, PageMode backing) noexcept {
+    chunk_map_.set(chunk, static_cast<uint8_t>(static_cast<uint8_t>(backing) + 1));
+    chunks_by_backing_[static_cast<size_t>(backing)].fetch_add(1, std::memory_order_relaxed);
+    chunks_mapped_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Stop trying `mode` until the next probe() finds pages for it again
+  static void record_failure(PageMode mode) noexcept {
+    unavailable_mask_.fetch_or(strategy_bit(mode), std::memory_order_relaxed);
+    hugetlb_failures_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static void update_strategy(PageMode mode, internal::Availability availability) noexcept {
+    if (availability == internal::Availability::kUnavailable) {
+      unavailable_mask_.fetch_or(strategy_bit(mode), std::memory_order_relaxed);
+    } else {
+      unavailable_mask_.fetch_and(static_cast<uint8_t>(~strategy_bit(mode)),
+                                  std::memory_order_relaxed);
+    }
+  }
+
+  [[nodiscard]] static constexpr uint8_t strategy_bit(PageMode mode) noexcept {
+    return mode == PageMode::kRegular ? 0 : static_cast<uint8_t>(1u << static_cast<uint8_t>(mode));
+  }
+
+  // Reuse a previously returned gigantic chunk, else carve the next 2MB of the current region,
+  // mapping a fresh 1GB region once it is exhausted.
+  [[nodiscard]] static void* allocate_gigantic_chunk(int populate_flag) noexcept {
+    if (void* chunk = gigantic_free_chunks().pop()) {
+      return chunk;
+    }
+
+    internal::GiganticCursor current = gigantic_cursor_.load(std::memory_order_acquire);
+    while (true) {
+      if (current.base != nullptr && current.next < PageTraits::kChunksPerGiganticPage) {
+        internal::GiganticCursor advanced{current.base, current.next + 1};
+        if (gigantic_cursor_.compare_exchange_weak(current, advanced, std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+          void* chunk = current.base + current.next * PageTraits::kChunkSize;
+          record_chunk(chunk, PageMode::kHugetlb1G);
+          return chunk;
+        }
+        continue;
+      }
+
+      if (!strategy_available(PageMode::kHugetlb1G)) {
+        return nullptr;
+      }
+
+      // The region's slot is reserved before mapping, so a region never exists without one
+      const size_t slot = gigantic_region_count_.fetch_add(1, std::memory_order_acq_rel);
+      if (slot >= kMaxGiganticRegions) {
+        release_gigantic_slot(slot);
+        return nullptr;
+      }
+
+      void* region = mmap(nullptr, PageTraits::kGiganticPageSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | kMapHuge1GB | populate_flag,
+                          -1, 0);
+      if (region == MAP_FAILED) {
+        release_gigantic_slot(slot);
+        record_failure(PageMode::kHugetlb1G);
+        return nullptr;  // No 1GB pages available, caller falls back to 2MB pages
+      }
+
+      // Registered before it is published, so chunks carved from it by other threads are
+      // recognised as gigantic as soon as they can exist
+      gigantic_regions_[slot].store(static_cast<char*>(region), std::memory_order_release);
+
+      // Chunk 0 is ours, the rest is published through the cursor
+      internal::GiganticCursor fresh{static_cast<char*>(region), 1};
+      if (gigantic_cursor_.compare_exchange_strong(current, fresh, std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+        record_chunk(region, PageMode::kHugetlb1G);
+        return region;
+      }
+
+      // Another thread installed a region first; give ours back and carve from theirs
+      gigantic_regions_[slot].store(nullptr, std::memory_order_release);
+      release_gigantic_slot(slot);
+      munmap(region, PageTraits::kGiganticPageSize);
+    }
+  }
+
+  // Undo the reservation of `slot`, which holds no region. Only the newest reservation can be
+  // rolled back; an older one stays as an empty slot, which lookups skip.
+  static void release_gigantic_slot(size_t slot) noexcept {
+    size_t expected = slot + 1;
+    gigantic_region_count_.compare_exchange_strong(expected, slot, std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed);
+  }
+
+  // Regions currently mapped, for stats(): reserved slots minus empty ones
+  [[nodiscard]] static size_t gigantic_region_count() noexcept {
+    const size_t slots =
+        std::min(gigantic_region_count_.load(std::memory_order_acquire), kMaxGiganticRegions);
+    size_t count = 0;
+    for (size_t i = 0; i < slots; ++i) {
+      count += gigantic_regions_[i].load(std::memory_order_relaxed) != nullptr ? 1 : 0;
+    }
+    return count;
+  }
+
+  [[nodiscard]] static bool in_gigantic_region(const void* ptr) noexcept {
+    const size_t count =
+        std::min(gigantic_region_count_.load(std::memory_order_acquire), kMaxGiganticRegions);
+    const char* p = static_cast<const char*>(ptr);
+    for (size_t i = 0; i < count; ++i) {
+      const char* base = gigantic_regions_[i].load(std::memory_order_acquire);
+      if (base != nullptr && p >= base && p < base + PageTraits::kGiganticPageSize) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static AtomicStack& gigantic_free_chunks() noexcept {
+    static AtomicStack stack;
+    return stack;
+  }
+
+  // Over-map by one chunk and trim, so the chunk is aligned to its own size: slab_base_from_ptr()
+  // masks block pointers down to the chunk, and THP can only back 2MB-aligned ranges. With
+  // `transparent` the chunk is madvised for THP before it is first touched.
+  [[nodiscard]] static void* allocate_regular_chunk(int populate_flag, bool transparent) noexcept {
+    constexpr size_t kSpan = 2 * PageTraits::kChunkSize;
+    // No MAP_POPULATE here: it would fault in the part that is trimmed off
+    void* raw = mmap(nullptr, kSpan, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      return nullptr;
+    }
+
+    char* base = static_cast<char*>(raw);
+    char* ptr = reinterpret_cast<char*>(
+        internal::align_up(reinterpret_cast<uintptr_t>(base), uintptr_t{PageTraits::kChunkSize}));
+    const size_t head = static_cast<size_t>(ptr - base);
+    if (head > 0) {
+      munmap(base, head);
+    }
+    if (kSpan - head > PageTraits::kChunkSize) {
+      munmap(ptr + PageTraits::kChunkSize, kSpan - head - PageTraits::kChunkSize);
+    }
+
+    if (transparent) {
+      madvise(ptr, PageTraits::kChunkSize, MADV_HUGEPAGE);
+    }
+    if (populate_flag != 0) {
+      populate(ptr, PageTraits::kChunkSize);
+    }
+    if (transparent && thp_collapse()) {
+      madvise(ptr, PageTraits::kChunkSize, kMadvCollapse);
+    }
+    return ptr;
+  }
+
+  static LargeCache& large_cache() noexcept {
+    static LargeCache cache;
+    return cache;
+  }
+
+  [[nodiscard]] static void* take_cached_large(size_t size) noexcept {
+    if (large_cached_bytes_.load(std::memory_order_relaxed) == 0) [[likely]] {
+      return nullptr;
+    }
+    LargeCache& cache = large_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    for (size_t i = 0; i < cache.count; ++i) {
+      if (cache.entries[i].size == size) {
+        void* ptr = cache.entries[i].ptr;
+        cache.entries[i] = cache.entries[--cache.count];
+        large_cached_bytes_.fetch_sub(size, std::memory_order_relaxed);
+        return ptr;
+      }
+    }
+    return nullptr;
+  }
+
+  [[nodiscard]] static bool cache_large(void* ptr, size_t size) noexcept {
+    const size_t limit = large_cache_limit();
+    if (limit == 0) [[likely]] {
+      return false;
+    }
+    LargeCache& cache = large_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    const size_t cached = large_cached_bytes_.load(std::memory_order_relaxed);
+    if (cache.count == kLargeCacheSlots || size > limit - std::min(limit, cached)) {
+      return false;
+    }
+    cache.entries[cache.count++] = {ptr, size};
+    large_cached_bytes_.fetch_add(size, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Registered with atexit() on first use when NEXUSALLOC_CONF has stats:true
+  static void print_exit_stats() noexcept {
+    const ProviderStats s = stats();
+    std::fprintf(stderr,
+                 "nexusalloc: mapped=%zu bytes chunks=%zu (regular=%zu thp=%zu hugetlb_2m=%zu "
+                 "hugetlb_1g=%zu) pooled=%zu large=%zu (%zu bytes, %zu cached) "
+                 "hugetlb_failures=%zu\n",
+                 s.mapped_bytes(), s.chunks_mapped, s.chunks_by_backing[0], s.chunks_by_backing[1],
+                 s.chunks_by_backing[2], s.chunks_by_backing[3],
+                 global_page_stack().approximate_size(), s.large_allocations, s.large_bytes,
+                 s.large_cached_bytes, s.hugetlb_failures);
+  }
+
+  // Write one byte per regular page so the kernel allocates (and zeroes) every page now
+  static void prefault(void* ptr, size_t size) noexcept {
+    volatile char* p = static_cast<volatile char*>(ptr);
+    for (size_t offset = 0; offset < size; offset += PageTraits::kRegularPageSize) {
+      p[offset] = 0;
+    }
+  }
+
   static inline std::atomic<bool> memory_locked_{false};
+  static inline std::atomic<bool> thp_collapse_{false};
+  static inline std::atomic<uint8_t> populate_policy_{kUnset};
+  static inline std::atomic<uint8_t> page_mode_{kUnset};
+  static inline std::atomic<size_t> large_cache_limit_{kUnsetLimit};
+  static inline std::atomic<size_t> large_cached_bytes_{0};
+  static inline std::atomic<size_t> soft_limit_{kUnsetLimit};
+  static inline std::atomic<size_t> hard_limit_{kUnsetLimit};
+  static inline std::atomic<bool> under_pressure_{false};
+  static inline std::atomic<size_t> limit_failures_{0};
+  static inline std::atomic<size_t> pressure_events_{0};
+  static inline std::atomic<void (*)()> cache_purger_{nullptr};
+
+  static inline std::atomic<size_t> chunks_mapped_{0};
+  static inline std::atomic<size_t> chunks_by_backing_[kPageModeCount]{};
+  static inline std::atomic<size_t> chunk_requests_{0};
+  static inline std::atomic<size_t> hugetlb_failures_{0};
+  static inline std::atomic<uint8_t> unavailable_mask_{0};  // One bit per PageMode
+  static inline internal::ChunkMap chunk_map_{};
+  static inline std::atomic<size_t> large_allocations_{0};
+  static inline std::atomic<size_t> large_bytes_{0};
+
+  alignas(16) static inline std::atomic<internal::GiganticCursor> gigantic_cursor_{};
+  static inline std::atomic<size_t> gigantic_region_count_{0};  // Slots reserved, some empty
+  static inline std::atomic<char*> gigantic_regions_[kMaxGiganticRegions]{};
 };
 
 }  // namespace nexusalloc
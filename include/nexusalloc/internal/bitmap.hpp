@@ -5,16 +5,23 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "nexusalloc/internal/bitmap_simd.hpp"
 
 namespace nexusalloc::internal {
 
 // Fixed-size bitmap for tracking block occupancy
-// Uses 64-bit words for efficient operations
+// Uses 64-bit words for efficient operations. Whole-bitmap scans of large bitmaps run on the
+// AVX2/AVX-512 kernels in bitmap_simd.hpp when the CPU has them; small bitmaps and constant
+// evaluation stay scalar.
 template <size_t NumBits>
 class Bitmap {
  public:
   static constexpr size_t kBitsPerWord = 64;
   static constexpr size_t kNumWords = (NumBits + kBitsPerWord - 1) / kBitsPerWord;
+  static constexpr size_t kSimdMinWords = 8;  // Below this the dispatch costs more than it saves
 
   constexpr Bitmap() noexcept = default;
 
@@ -34,6 +41,7 @@ class Bitmap {
   }
 
   [[nodiscard]] constexpr size_t count() const noexcept {
+    if (use_simd()) return popcount_words(words_.data(), kNumWords);
     size_t total = 0;
     for (const auto& word : words_) {
       total += static_cast<size_t>(std::popcount(word));
@@ -42,17 +50,12 @@ class Bitmap {
   }
 
   [[nodiscard]] constexpr bool none() const noexcept {
-    for (const auto& word : words_) {
-      if (word != 0) return false;
-    }
-    return true;
+    return find_word(0, kNumWords, 0) == kNumWords;
   }
 
   [[nodiscard]] constexpr bool all() const noexcept {
     // Check all fully used words
-    for (size_t i = 0; i < kNumWords - 1; ++i) {
-      if (words_[i] != std::numeric_limits<uint64_t>::max()) return false;
-    }
+    if (find_word(0, kNumWords - 1, kAllOnes) != kNumWords - 1) return false;
     // Check last word (may have unused bits)
     constexpr size_t last_word_bits = NumBits % kBitsPerWord;
     if constexpr (last_word_bits == 0) {
@@ -64,26 +67,124 @@ class Bitmap {
   }
 
   [[nodiscard]] constexpr size_t find_first_clear() const noexcept {
-    for (size_t i = 0; i < kNumWords; ++i) {
-      uint64_t inverted = ~words_[i];
-      if (inverted != 0) {
-        size_t bit_in_word = static_cast<size_t>(std::countr_zero(inverted));
-        size_t global_idx = i * kBitsPerWord + bit_in_word;
-        return (global_idx < NumBits) ? global_idx : NumBits;
-      }
+    return find_first_clear_from(0);
+  }
+
+  // First clear bit at or after `start`, or size() if there is none
+  [[nodiscard]] constexpr size_t find_first_clear_from(size_t start) const noexcept {
+    return find_from(start, kAllOnes);
+  }
+
+  // First set bit at or after `start`, or size() if there is none
+  [[nodiscard]] constexpr size_t find_first_set_from(size_t start) const noexcept {
+    return find_from(start, 0);
+  }
+
+  // Start of the first run of `n` consecutive clear bits, or size() if there is none
+  [[nodiscard]] constexpr size_t find_run_of_clear(size_t n) const noexcept {
+    if (n == 0) return 0;
+    if (n > NumBits) return NumBits;
+    size_t start = find_first_clear_from(0);
+    while (start < NumBits) {
+      const size_t end = find_first_set_from(start);
+      if (end - start >= n) return start;
+      start = find_first_clear_from(end);
     }
     return NumBits;
   }
 
+  // Call `fn(index)` for every set bit below `end`, in increasing order. Clear words are skipped
+  // whole, so the cost is one read per word plus one call per set bit.
+  template <typename Fn>
+  constexpr void for_each_set(Fn&& fn, size_t end = NumBits) const {
+    end = end < NumBits ? end : NumBits;
+    for (size_t word_idx = 0; word_idx * kBitsPerWord < end; ++word_idx) {
+      uint64_t bits = words_[word_idx];
+      const size_t base = word_idx * kBitsPerWord;
+      if (end - base < kBitsPerWord) bits &= (1ULL << (end - base)) - 1;
+      while (bits != 0) {
+        fn(base + static_cast<size_t>(std::countr_zero(bits)));
+        bits &= bits - 1;
+      }
+    }
+  }
+
+  // Set bits [begin, end); the range is clamped to size()
+  constexpr void set_range(size_t begin, size_t end) noexcept {
+    apply_range(begin, end, [](uint64_t& word, uint64_t mask) { word |= mask; });
+  }
+
+  // Clear bits [begin, end); the range is clamped to size()
+  constexpr void clear_range(size_t begin, size_t end) noexcept {
+    apply_range(begin, end, [](uint64_t& word, uint64_t mask) { word &= ~mask; });
+  }
+
   constexpr void reset() noexcept { words_.fill(0); }
 
+  // Raw 64-bit word holding bits [64 * word_idx, 64 * word_idx + 64)
+  [[nodiscard]] constexpr uint64_t word(size_t word_idx) const noexcept { return words_[word_idx]; }
+
   [[nodiscard]] static constexpr size_t size() noexcept { return NumBits; }
 
  private:
+  static constexpr uint64_t kAllOnes = std::numeric_limits<uint64_t>::max();
+
   [[nodiscard]] static constexpr std::pair<size_t, size_t> decompose(size_t index) noexcept {
     return {index / kBitsPerWord, index % kBitsPerWord};
   }
 
+  [[nodiscard]] static constexpr bool use_simd() noexcept {
+    return kNumWords >= kSimdMinWords && !std::is_constant_evaluated();
+  }
+
+  // First word in [begin, end) that differs from `value`, or end. The first few words are checked
+  // inline, since searches that stop early (runs, find-from) would otherwise pay for dispatch.
+  [[nodiscard]] constexpr size_t find_word(size_t begin, size_t end,
+                                           uint64_t value) const noexcept {
+    constexpr size_t kInlineWords = 4;
+    for (size_t i = begin; i < end; ++i) {
+      if (words_[i] != value) return i;
+      if (i - begin + 1 == kInlineWords && use_simd()) {
+        return find_word_not_equal(words_.data(), i + 1, end, value);
+      }
+    }
+    return end;
+  }
+
+  // First bit at or after `start` in a word that differs from `skip` (all ones when looking for
+  // a clear bit, zero when looking for a set one)
+  [[nodiscard]] constexpr size_t find_from(size_t start, uint64_t skip) const noexcept {
+    if (start >= NumBits) return NumBits;
+    auto [word_idx, bit_idx] = decompose(start);
+    uint64_t bits = (words_[word_idx] ^ skip) & (kAllOnes << bit_idx);
+    if (bits == 0) {
+      word_idx = find_word(word_idx + 1, kNumWords, skip);
+      if (word_idx == kNumWords) return NumBits;
+      bits = words_[word_idx] ^ skip;
+    }
+    const size_t index = word_idx * kBitsPerWord + static_cast<size_t>(std::countr_zero(bits));
+    return index < NumBits ? index : NumBits;
+  }
+
+  template <typename Op>
+  constexpr void apply_range(size_t begin, size_t end, Op op) noexcept {
+    end = end < NumBits ? end : NumBits;
+    if (begin >= end) return;
+    const auto [first_word, first_bit] = decompose(begin);
+    const auto [last_word, last_bit] = decompose(end - 1);
+    const uint64_t first_mask = kAllOnes << first_bit;
+    const uint64_t last_mask = kAllOnes >> (kBitsPerWord - 1 - last_bit);
+    if (first_word == last_word) {
+      op(words_[first_word], first_mask & last_mask);
+      return;
+    }
+    op(words_[first_word], first_mask);
+    for (size_t i = first_word + 1; i < last_word; ++i) {
+      op(words_[i], kAllOnes);  // Vectorized by the compiler
+    }
+    op(words_[last_word], last_mask);
+  }
+
   std::array<uint64_t, kNumWords> words_{};
 };
 
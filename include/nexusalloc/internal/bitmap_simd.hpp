@@ -0,0 +1,162 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NEXUS_BITMAP_X86 1
+#include <immintrin.h>
+#endif
+
+namespace nexusalloc::internal {
+
+// Word-array kernels behind Bitmap's whole-bitmap scans. Each has a scalar version and, on
+// x86-64, AVX2 and AVX-512 versions compiled with target attributes, so they are available
+// without -mavx2 and picked at run time by what the CPU supports.
+enum class SimdLevel : uint8_t {
+  kScalar,
+  kAvx2,    // AVX2
+  kAvx512,  // AVX-512 F, BW and VPOPCNTDQ
+};
+
+[[nodiscard]] inline SimdLevel detect_simd_level() noexcept {
+#ifdef NEXUS_BITMAP_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512vpopcntdq")) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) return SimdLevel::kAvx2;
+#endif
+  return SimdLevel::kScalar;
+}
+
+// Best level this CPU supports, detected once
+[[nodiscard]] inline SimdLevel simd_level() noexcept {
+  static const SimdLevel level = detect_simd_level();
+  return level;
+}
+
+namespace simd {
+
+[[nodiscard]] inline size_t popcount_scalar(const uint64_t* words, size_t n) noexcept {
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i) {
+    total += static_cast<size_t>(std::popcount(words[i]));
+  }
+  return total;
+}
+
+// Index of the first word in [begin, n) that differs from `value`, or n
+[[nodiscard]] inline size_t find_word_not_equal_scalar(const uint64_t* words, size_t begin,
+                                                       size_t n, uint64_t value) noexcept {
+  for (size_t i = begin; i < n; ++i) {
+    if (words[i] != value) return i;
+  }
+  return n;
+}
+
+#ifdef NEXUS_BITMAP_X86
+
+// Per-byte popcount through a nibble lookup table, summed into 64-bit lanes by vpsadbw
+[[gnu::target("avx2")]] [[nodiscard]] inline size_t popcount_avx2(const uint64_t* words,
+                                                                  size_t n) noexcept {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1,
+                       2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i sums = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+    const __m256i hi =
+        _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+    sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+  }
+  alignas(32) uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+  return static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+         popcount_scalar(words + i, n - i);
+}
+
+[[gnu::target("avx2")]] [[nodiscard]] inline size_t find_word_not_equal_avx2(
+    const uint64_t* words, size_t begin, size_t n, uint64_t value) noexcept {
+  const __m256i pattern = _mm256_set1_epi64x(static_cast<long long>(value));
+  size_t i = begin;
+  for (; i + 4 <= n; i += 4) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    const auto equal = static_cast<unsigned>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, pattern))));
+    if (equal != 0xf) return i + static_cast<size_t>(std::countr_one(equal));
+  }
+  return find_word_not_equal_scalar(words, i, n, value);
+}
+
+[[gnu::target("avx512f,avx512bw,avx512vpopcntdq")]] [[nodiscard]] inline size_t popcount_avx512(
+    const uint64_t* words, size_t n) noexcept {
+  __m512i sums = _mm512_setzero_si512();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    sums = _mm512_add_epi64(sums, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+  }
+  alignas(64) uint64_t lanes[8];
+  _mm512_store_si512(lanes, sums);
+  return static_cast<size_t>(popcount_scalar(words + i, n - i) + lanes[0] + lanes[1] + lanes[2] +
+                             lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7]);
+}
+
+[[gnu::target("avx512f,avx512bw,avx512vpopcntdq")]] [[nodiscard]] inline size_t
+find_word_not_equal_avx512(const uint64_t* words, size_t begin, size_t n, uint64_t value) noexcept {
+  const __m512i pattern = _mm512_set1_epi64(static_cast<long long>(value));
+  size_t i = begin;
+  for (; i + 8 <= n; i += 8) {
+    const __mmask8 differ = _mm512_cmpneq_epi64_mask(_mm512_loadu_si512(words + i), pattern);
+    if (differ != 0) return i + static_cast<size_t>(std::countr_zero(differ));
+  }
+  return find_word_not_equal_scalar(words, i, n, value);
+}
+
+#endif  // NEXUS_BITMAP_X86
+
+}  // namespace simd
+
+[[nodiscard]] inline size_t popcount_words(const uint64_t* words, size_t n,
+                                           SimdLevel level = simd_level()) noexcept {
+#ifdef NEXUS_BITMAP_X86
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return simd::popcount_avx512(words, n);
+    case SimdLevel::kAvx2:
+      return simd::popcount_avx2(words, n);
+    case SimdLevel::kScalar:
+      break;
+  }
+#else
+  (void)level;
+#endif
+  return simd::popcount_scalar(words, n);
+}
+
+[[nodiscard]] inline size_t find_word_not_equal(const uint64_t* words, size_t begin, size_t n,
+                                                uint64_t value,
+                                                SimdLevel level = simd_level()) noexcept {
+#ifdef NEXUS_BITMAP_X86
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return simd::find_word_not_equal_avx512(words, begin, n, value);
+    case SimdLevel::kAvx2:
+      return simd::find_word_not_equal_avx2(words, begin, n, value);
+    case SimdLevel::kScalar:
+      break;
+  }
+#else
+  (void)level;
+#endif
+  return simd::find_word_not_equal_scalar(words, begin, n, value);
+}
+
+}  // namespace nexusalloc::internal
+
+#undef NEXUS_BITMAP_X86
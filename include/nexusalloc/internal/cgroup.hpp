@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace nexusalloc::internal {
+
+// cgroup v2 memory limits of this process, in bytes; unlimited when unset or unreadable
+struct CgroupMemoryLimits {
+  static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
+
+  size_t max{kUnlimited};   // memory.max: the OOM killer's limit
+  size_t high{kUnlimited};  // memory.high: the kernel throttles and reclaims above it
+};
+
+// Parse a cgroup v2 limit file's contents: a byte count, or "max" for no limit
+[[nodiscard]] inline bool parse_cgroup_limit(const char* text, size_t& out) noexcept {
+  if (std::strncmp(text, "max", 3) == 0) {
+    out = CgroupMemoryLimits::kUnlimited;
+    return true;
+  }
+  unsigned long long value = 0;
+  if (std::sscanf(text, "%llu", &value) != 1) return false;
+  out = static_cast<size_t>(value);
+  return true;
+}
+
+inline bool read_cgroup_limit(const char* dir, const char* file, size_t& out) noexcept {
+  char path[512];
+  if (std::snprintf(path, sizeof(path), "%s/%s", dir, file) >= static_cast<int>(sizeof(path))) {
+    return false;
+  }
+  FILE* f = std::fopen(path, "r");
+  if (f == nullptr) return false;
+  char line[64] = {};
+  const bool ok = std::fgets(line, sizeof(line), f) != nullptr && parse_cgroup_limit(line, out);
+  std::fclose(f);
+  return ok;
+}
+
+// Limits of the cgroup v2 group named in /proc/self/cgroup ("0::<path>"), looked up under
+// `root`. Inside a cgroup namespace the group is usually mounted at the root itself, which is
+// tried when the full path does not exist.
+[[nodiscard]] inline CgroupMemoryLimits cgroup_memory_limits(
+    const char* root = "/sys/fs/cgroup", const char* self = "/proc/self/cgroup") noexcept {
+  CgroupMemoryLimits limits;
+
+  char group[256] = {};
+  if (FILE* f = std::fopen(self, "r")) {
+    while (std::fgets(group, sizeof(group), f) != nullptr) {
+      if (std::strncmp(group, "0::", 3) == 0) {
+        group[std::strcspn(group, "\n")] = '\0';
+        break;
+      }
+      group[0] = '\0';
+    }
+    std::fclose(f);
+  }
+  const char* path = std::strncmp(group, "0::", 3) == 0 ? group + 3 : "";
+
+  char dir[512];
+  std::snprintf(dir, sizeof(dir), "%s%s", root, std::strcmp(path, "/") == 0 ? "" : path);
+  if (!read_cgroup_limit(dir, "memory.max", limits.max)) {
+    std::snprintf(dir, sizeof(dir), "%s", root);
+    if (!read_cgroup_limit(dir, "memory.max", limits.max)) return limits;
+  }
+  if (!read_cgroup_limit(dir, "memory.high", limits.high)) {
+    limits.high = CgroupMemoryLimits::kUnlimited;
+  }
+  return limits;
+}
+
+}  // namespace nexusalloc::internal
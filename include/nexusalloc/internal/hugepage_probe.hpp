@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace nexusalloc::internal {
+
+enum class Availability : unsigned char { kUnknown, kAvailable, kUnavailable };
+
+// Reads a single unsigned integer from a sysfs file, or returns false if it cannot be read
+inline bool read_sysfs_value(const char* path, unsigned long& value) noexcept {
+  FILE* f = std::fopen(path, "r");
+  if (f == nullptr) return false;
+  const bool ok = std::fscanf(f, "%lu", &value) == 1;
+  std::fclose(f);
+  return ok;
+}
+
+// Whether a MAP_HUGETLB mapping of `page_kb` pages can currently succeed, judged from the pool
+// counters under /sys/kernel/mm/hugepages. Surplus pages count while the overcommit limit allows
+// them. kUnknown when sysfs is not readable (containers), so the caller should just try.
+[[nodiscard]] inline Availability hugetlb_availability(size_t page_kb) noexcept {
+  char path[96];
+  unsigned long free_pages = 0;
+  std::snprintf(path, sizeof(path), "/sys/kernel/mm/hugepages/hugepages-%zukB/free_hugepages",
+                page_kb);
+  if (!read_sysfs_value(path, free_pages)) return Availability::kUnknown;
+  if (free_pages > 0) return Availability::kAvailable;
+
+  unsigned long overcommit = 0;
+  unsigned long surplus = 0;
+  std::snprintf(path, sizeof(path),
+                "/sys/kernel/mm/hugepages/hugepages-%zukB/nr_overcommit_hugepages", page_kb);
+  if (!read_sysfs_value(path, overcommit)) return Availability::kUnavailable;
+  std::snprintf(path, sizeof(path), "/sys/kernel/mm/hugepages/hugepages-%zukB/surplus_hugepages",
+                page_kb);
+  if (!read_sysfs_value(path, surplus)) return Availability::kUnavailable;
+  return overcommit > surplus ? Availability::kAvailable : Availability::kUnavailable;
+}
+
+// Whether madvise(MADV_HUGEPAGE) can get THP backing: the active setting in
+// /sys/kernel/mm/transparent_hugepage/enabled is "[always]" or "[madvise]", not "[never]".
+[[nodiscard]] inline Availability thp_availability() noexcept {
+  FILE* f = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+  if (f == nullptr) return Availability::kUnknown;
+
+  char line[64] = {};
+  const bool ok = std::fgets(line, sizeof(line), f) != nullptr;
+  std::fclose(f);
+  if (!ok) return Availability::kUnknown;
+  return std::strstr(line, "[never]") != nullptr ? Availability::kUnavailable
+                                                 : Availability::kAvailable;
+}
+
+}  // namespace nexusalloc::internal
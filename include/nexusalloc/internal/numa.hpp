@@ -0,0 +1,48 @@
+#pragma once
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdio>
+
+namespace nexusalloc::internal {
+
+// Number of NUMA nodes the kernel reports as possible (highest node id + 1), or 1 on
+// non-NUMA systems. Parses /sys/devices/system/node/possible ("0", "0-3", "0,2-3", ...).
+[[nodiscard]] inline int numa_node_count() noexcept {
+  FILE* f = std::fopen("/sys/devices/system/node/possible", "r");
+  if (f == nullptr) return 1;
+
+  int max_node = 0;
+  int value = 0;
+  char separator = 0;
+  while (std::fscanf(f, "%d%c", &value, &separator) >= 1) {
+    if (value > max_node) max_node = value;
+    if (separator != '-' && separator != ',') break;
+    separator = 0;
+  }
+  std::fclose(f);
+  return max_node + 1;
+}
+
+// Set a preferred-node memory policy on [ptr, ptr + size) so pages are placed on `node` when
+// first touched, falling back to other nodes if it is full. Must be called before the range is
+// faulted in. Returns false if the policy could not be applied (e.g. kernel without NUMA).
+inline bool numa_prefer_node(void* ptr, size_t size, int node) noexcept {
+#ifdef SYS_mbind
+  constexpr int kMpolPreferred = 1;  // MPOL_PREFERRED from <linux/mempolicy.h>
+  constexpr size_t kBitsPerMask = sizeof(unsigned long) * 8;
+  if (node < 0 || static_cast<size_t>(node) >= kBitsPerMask) return false;
+
+  unsigned long nodemask = 1UL << node;
+  return syscall(SYS_mbind, ptr, size, kMpolPreferred, &nodemask, kBitsPerMask + 1, 0) == 0;
+#else
+  (void)ptr;
+  (void)size;
+  (void)node;
+  return false;
+#endif
+}
+
+}  // namespace nexusalloc::internal
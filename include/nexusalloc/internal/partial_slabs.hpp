@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "nexusalloc/slab.hpp"
+
+namespace nexusalloc::internal {
+
+// Partial slabs of one size class, bucketed by occupancy so the fullest can be taken in O(1).
+// Filling the fullest slabs first leaves sparse ones alone long enough to drain completely and
+// give their chunk back, instead of spreading live blocks thinly over every slab.
+class PartialSlabs {
+ public:
+  static constexpr size_t kBuckets = 4;  // Quarters of a slab's blocks in use, emptiest first
+
+  // Where a slab sits, valid until the next push, take or remove
+  struct Position {
+    size_t bucket;
+    size_t index;
+  };
+
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+  [[nodiscard]] size_t size() const noexcept { return size_; }
+
+  void push(SlabWrapper&& slab) {
+    const size_t bucket = bucket_of(slab);
+    buckets_[bucket].push_back(std::move(slab));
+    newest_ = bucket;
+    ++size_;
+  }
+
+  // Fullest non-full slab; the container must not be empty
+  [[nodiscard]] SlabWrapper take_fullest() noexcept {
+    for (size_t bucket = kBuckets; bucket-- > 0;) {
+      if (!buckets_[bucket].empty()) return take_back(bucket);
+    }
+    return {};
+  }
+
+  // Last slab pushed if it is still in its bucket, ignoring occupancy
+  [[nodiscard]] SlabWrapper take_newest() noexcept {
+    if (!buckets_[newest_].empty()) return take_back(newest_);
+    return take_fullest();
+  }
+
+  [[nodiscard]] SlabWrapper* find(const void* base, Position& pos) noexcept {
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+      auto& slabs = buckets_[bucket];
+      for (size_t i = 0; i < slabs.size(); ++i) {
+        if (slabs[i].base() == base) {
+          pos = {bucket, i};
+          return &slabs[i];
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  [[nodiscard]] SlabWrapper& at(Position pos) noexcept { return buckets_[pos.bucket][pos.index]; }
+
+  [[nodiscard]] SlabWrapper remove(Position pos) noexcept {
+    auto& slabs = buckets_[pos.bucket];
+    SlabWrapper slab = std::move(slabs[pos.index]);
+    if (pos.index + 1 != slabs.size()) {
+      slabs[pos.index] = std::move(slabs.back());
+    }
+    slabs.pop_back();
+    --size_;
+    return slab;
+  }
+
+  // Re-bucket the slab at `pos` after blocks were freed into it
+  void update(Position pos) {
+    if (bucket_of(at(pos)) != pos.bucket) {
+      push(remove(pos));
+    }
+  }
+
+  // Empty slabs all sit in the lowest bucket
+  [[nodiscard]] size_t count_empty() const noexcept {
+    size_t count = 0;
+    for (const auto& slab : buckets_[0]) {
+      count += slab.empty() ? 1 : 0;
+    }
+    return count;
+  }
+
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    for (const auto& slabs : buckets_) {
+      for (const auto& slab : slabs) fn(slab);
+    }
+  }
+
+  void clear() noexcept {
+    for (auto& slabs : buckets_) slabs.clear();
+    size_ = 0;
+  }
+
+ private:
+  [[nodiscard]] static size_t bucket_of(const SlabWrapper& slab) noexcept {
+    const size_t used = slab.used_blocks();
+    const size_t capacity = used + slab.free_blocks();
+    return capacity == 0 ? 0 : std::min(used * kBuckets / capacity, kBuckets - 1);
+  }
+
+  [[nodiscard]] SlabWrapper take_back(size_t bucket) noexcept {
+    SlabWrapper slab = std::move(buckets_[bucket].back());
+    buckets_[bucket].pop_back();
+    --size_;
+    return slab;
+  }
+
+  std::array<std::vector<SlabWrapper>, kBuckets> buckets_;
+  size_t size_{0};
+  size_t newest_{0};
+};
+
+}  // namespace nexusalloc::internal
@@ -1,11 +1,104 @@
 #pragma once
 
+#include <optional>
+
 #include "nexusalloc/allocator.hpp"
+#include "nexusalloc/region.hpp"
 #include "nexusalloc/thread_arena.hpp"
 
 namespace nexusalloc {
 
-inline void initialize() { HugepageProvider::lock_memory(); }
+// Pre-map and pre-fault enough chunks to cover `bytes` and park them in global_page_stack(), so
+// threads pick them up without an mmap on their first allocations. With `numa_spread` (or
+// numa:spread in NEXUSALLOC_CONF), chunks are placed round-robin across NUMA nodes. Returns the
+// number of chunks added to the pool.
+inline size_t reserve(size_t bytes, bool numa_spread = false) noexcept {
+  numa_spread |= config().numa == NumaPolicy::kSpread;
+  const size_t num_chunks =
+      internal::align_up(bytes, PageTraits::kChunkSize) / PageTraits::kChunkSize;
+  const int num_nodes = numa_spread ? internal::numa_node_count() : 1;
+
+  size_t reserved = 0;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    void* chunk = numa_spread
+                      ? HugepageProvider::allocate_chunk_on_node(static_cast<int>(i) % num_nodes)
+                      : HugepageProvider::allocate_populated_chunk();
+    if (chunk == nullptr) break;
+    global_page_stack().push(chunk);
+    ++reserved;
+  }
+  return reserved;
+}
+
+struct InitOptions {
+  std::optional<PageMode> page_mode{};       // Chunk page size; unset keeps the current mode
+  bool thp_collapse{false};                  // MADV_COLLAPSE THP chunks that faulted as 4KB
+  std::optional<PopulatePolicy> populate{};  // Unset keeps NEXUSALLOC_CONF populate
+  bool lock_memory{true};                    // mlockall(MCL_CURRENT | MCL_FUTURE)
+  size_t reserve_bytes{0};                   // Chunks to pre-map and pre-fault into the pool
+  bool numa_spread{false};                   // Spread reserved chunks across NUMA nodes
+  bool background_refill{false};             // Keep the pool topped up from a background thread
+  RefillOptions refill{};                    // Watermarks for the background refill thread
+};
+
+inline void initialize(const InitOptions& options = {}) {
+  if (options.page_mode) {
+    HugepageProvider::set_page_mode(*options.page_mode);
+  }
+  HugepageProvider::probe();
+  if (options.thp_collapse) {
+    HugepageProvider::set_thp_collapse(true);
+  }
+  if (options.populate) {
+    HugepageProvider::set_populate_policy(*options.populate);
+  }
+  if (options.lock_memory) {
+    HugepageProvider::lock_memory();
+  }
+  if (options.reserve_bytes > 0) {
+    reserve(options.reserve_bytes, options.numa_spread);
+  }
+  if (options.background_refill ||
+      HugepageProvider::populate_policy() == PopulatePolicy::kBackground) {
+    ChunkRefiller::start(options.refill);
+  } else if (options.refill.decay.count() > 0) {
+    // Decay needs the background thread even when nothing asked for refilling
+    RefillOptions decay_only = options.refill;
+    decay_only.low_watermark = 0;
+    decay_only.high_watermark = 0;
+    ChunkRefiller::start(decay_only);
+  }
+}
+
+// Process-wide allocator statistics. Counters are read with relaxed ordering, so a snapshot taken
+// while other threads allocate is approximate but never blocks them.
+struct Stats {
+  ProviderStats provider;    // Memory currently mapped from the OS
+  size_t chunks_pooled{0};   // Chunks idle in the global page stack, ready for reuse
+  size_t slabs_cached{0};    // Empty slabs in the central cache, ready for any thread
+
+  [[nodiscard]] size_t mapped_bytes() const noexcept { return provider.mapped_bytes(); }
+};
+
+[[nodiscard]] inline Stats stats() noexcept {
+  Stats result;
+  result.provider = HugepageProvider::stats();
+  result.chunks_pooled = global_page_stack().approximate_size();
+  result.slabs_cached = central_cache().slab_count();
+  return result;
+}
+
+// Call `fn(ptr, size)` for every live block of every thread arena, bound to a thread or parked,
+// and, with Heap::track_shared_large() on, for every large allocation made through them: for
+// leak hunting and heap snapshots. Sizes are block sizes and page-rounded mapping sizes, not the
+// sizes originally requested. Standalone
+// heaps are walked with Heap::for_each_live_block(). The walk allocates nothing; other threads
+// must not allocate or free through nexusalloc while it runs, and neither may `fn`.
+template <typename Fn>
+void for_each_live_block(Fn&& fn) {
+  ThreadArena::for_each_arena([&](const ThreadArena& arena) { arena.for_each_live_block(fn); });
+  Heap::for_each_shared_large_block(fn);
+}
 
 [[nodiscard, gnu::hot]] inline void* allocate(size_t size) noexcept {
   return ThreadArena::get().allocate(size);
@@ -14,4 +107,23 @@ inline void initialize() { HugepageProvider::lock_memory(); }
   ThreadArena::get().deallocate(ptr, size);
 }
 
+// Cache-line-isolated block (see flags::isolated_t); free it with the same flag
+[[nodiscard]] inline void* allocate(size_t size, flags::isolated_t flag) noexcept {
+  return ThreadArena::get().allocate(size, flag);
+}
+inline void deallocate(void* ptr, size_t size, flags::isolated_t flag) noexcept {
+  ThreadArena::get().deallocate(ptr, size, flag);
+}
+
+// Allocate `n` blocks of `size` bytes into `out`; returns how many were allocated (fewer than
+// `n` only when memory runs out). Cheaper per block than calling allocate() `n` times.
+[[nodiscard]] inline size_t allocate_batch(size_t size, void** out, size_t n) noexcept {
+  return ThreadArena::get().allocate_batch(size, out, n);
+}
+
+// Free `n` blocks of `size` bytes, e.g. the output of allocate_batch(). Null entries are skipped.
+inline void deallocate_batch(void* const* ptrs, size_t n, size_t size) noexcept {
+  ThreadArena::get().deallocate_batch(ptrs, n, size);
+}
+
 }  // namespace nexusalloc
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+#include "nexusalloc/hugepage_provider.hpp"
+#include "nexusalloc/internal/alignment.hpp"
+#include "nexusalloc/internal/size_class.hpp"
+#include "nexusalloc/region.hpp"
+#include "nexusalloc/thread_arena.hpp"
+
+namespace nexusalloc::pmr {
+
+// std::pmr::memory_resource over the calling thread's ThreadArena, for std::pmr containers.
+// Stateless like NexusAllocator: all instances compare equal. As with deallocate(), memory must be
+// released on the thread that allocated it.
+class thread_arena_resource : public std::pmr::memory_resource {
+ protected:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    if (over_aligned(bytes, alignment)) [[unlikely]] {
+      return allocate_over_aligned(bytes, alignment);
+    }
+    void* ptr = ThreadArena::get().allocate(request_size(bytes, alignment));
+    if (ptr == nullptr) [[unlikely]] {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+    if (over_aligned(bytes, alignment)) [[unlikely]] {
+      ThreadArena::get().deallocate(static_cast<void**>(ptr)[-1], bytes + alignment);
+      return;
+    }
+    ThreadArena::get().deallocate(ptr, request_size(bytes, alignment));
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return dynamic_cast<const thread_arena_resource*>(&other) != nullptr;
+  }
+
+ private:
+  // Blocks of a power-of-two size class are aligned to their size (slabs are chunk-aligned) and
+  // large allocations to a page, so rounding the request up to a power of two >= alignment is
+  // enough unless the result would need more than page alignment outside the slab classes.
+  [[nodiscard]] static constexpr size_t request_size(size_t bytes, size_t alignment) noexcept {
+    if (alignment <= internal::kMinAlignment || bytes > internal::SizeClass::kMaxSlabSize) {
+      return bytes;
+    }
+    return std::bit_ceil(std::max(bytes, alignment));
+  }
+
+  [[nodiscard]] static constexpr bool over_aligned(size_t bytes, size_t alignment) noexcept {
+    return alignment > PageTraits::kRegularPageSize &&
+           std::max(bytes, alignment) > internal::SizeClass::kMaxSlabSize;
+  }
+
+  // Over-allocate by `alignment` and keep the original pointer in the word below the result
+  [[nodiscard]] static void* allocate_over_aligned(size_t bytes, size_t alignment) {
+    if (bytes > std::numeric_limits<size_t>::max() - alignment) {
+      throw std::bad_alloc();
+    }
+    void* raw = ThreadArena::get().allocate(bytes + alignment);
+    if (raw == nullptr) {
+      throw std::bad_alloc();
+    }
+    const uintptr_t aligned =
+        internal::align_up(reinterpret_cast<uintptr_t>(raw) + sizeof(void*), uintptr_t{alignment});
+    void** result = reinterpret_cast<void**>(aligned);
+    result[-1] = raw;
+    return result;
+  }
+};
+
+// Shared instance, the counterpart of std::pmr::new_delete_resource()
+[[nodiscard]] inline thread_arena_resource* arena_resource() noexcept {
+  static thread_arena_resource instance;
+  return &instance;
+}
+
+// Monotonic std::pmr::memory_resource over a Region: bump allocation from whole 2MB chunks taken
+// from global_page_stack(), no-op deallocation, and release() (or destruction) handing every
+// chunk back to the pool at once.
+//
+// Not thread-safe, like std::pmr::monotonic_buffer_resource.
+class monotonic_chunk_resource : public std::pmr::memory_resource {
+ public:
+  monotonic_chunk_resource() noexcept = default;
+
+  monotonic_chunk_resource(const monotonic_chunk_resource&) = delete;
+  monotonic_chunk_resource& operator=(const monotonic_chunk_resource&) = delete;
+
+  void release() noexcept { region_.release(); }
+
+  // Chunks currently held (excluding oversized allocations)
+  [[nodiscard]] size_t chunk_count() const noexcept { return region_.chunk_count(); }
+
+ protected:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    void* ptr = region_.allocate(bytes, alignment);
+    if (ptr == nullptr) [[unlikely]] {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  void do_deallocate(void*, size_t, size_t) override {}  // Reclaimed by release()
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  Region region_;
+};
+
+}  // namespace nexusalloc::pmr
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "nexusalloc/heap.hpp"
+#include "nexusalloc/hugepage_provider.hpp"
+#include "nexusalloc/internal/alignment.hpp"
+
+namespace nexusalloc {
+
+// Monotonic region for per-request or per-frame lifetimes. Objects are bump-allocated from 2MB
+// chunks taken from global_page_stack() and never freed one by one: reset() drops everything but
+// keeps one chunk for the next round, release() gives every chunk back. Both return the chunks
+// to the pool in a single batch. Chunks are linked through a header in their first bytes, so a
+// region does no bookkeeping allocations of its own. Requests larger than a chunk get their own
+// mapping.
+//
+// Not thread-safe: a region belongs to one thread at a time.
+class Region {
+ public:
+  Region() noexcept = default;
+  ~Region() { release(); }
+
+  Region(const Region&) = delete;
+  Region& operator=(const Region&) = delete;
+
+  Region(Region&& other) noexcept { swap(other); }
+  Region& operator=(Region&& other) noexcept {
+    if (this != &other) {
+      release();
+      swap(other);
+    }
+    return *this;
+  }
+
+  // Returns nullptr when out of memory
+  [[nodiscard, gnu::hot]] void* allocate(size_t size,
+                                         size_t alignment = internal::kMinAlignment) noexcept {
+    const uintptr_t ptr =
+        internal::align_up(reinterpret_cast<uintptr_t>(cursor_), uintptr_t{alignment});
+    const uintptr_t end = reinterpret_cast<uintptr_t>(end_);
+    if (ptr < end && size <= end - ptr) [[likely]] {
+      cursor_ = reinterpret_cast<char*>(ptr + size);
+      return reinterpret_cast<void*>(ptr);
+    }
+    return allocate_slow(size, alignment);
+  }
+
+  // No-op: memory comes back with reset() or release()
+  void deallocate(void*, size_t) noexcept {}
+
+  // Drop every allocation. The current chunk is kept and rewound; the others go back to the pool
+  // and oversized allocations are unmapped.
+  void reset() noexcept {
+    release_oversized();
+    if (chunks_ == nullptr) return;
+
+    if (chunks_ != tail_) {
+      Heap::return_chunks(chunks_->next, tail_, chunk_count_ - 1);
+      chunks_->next = nullptr;
+      tail_ = chunks_;
+      chunk_count_ = 1;
+    }
+    cursor_ = reinterpret_cast<char*>(chunks_) + kHeaderSize;
+    end_ = reinterpret_cast<char*>(chunks_) + PageTraits::kChunkSize;
+  }
+
+  // Drop every allocation and return all chunks to the pool
+  void release() noexcept {
+    release_oversized();
+    if (chunks_ != nullptr) {
+      Heap::return_chunks(chunks_, tail_, chunk_count_);
+    }
+    chunks_ = nullptr;
+    tail_ = nullptr;
+    cursor_ = nullptr;
+    end_ = nullptr;
+    chunk_count_ = 0;
+  }
+
+  // Chunks currently held, excluding oversized allocations
+  [[nodiscard]] size_t chunk_count() const noexcept { return chunk_count_; }
+
+ private:
+  // `next` comes first so a chain of chunks is also an AtomicStack chain
+  struct Header {
+    Header* next;
+    size_t size;  // Mapping size of an oversized allocation
+  };
+  static constexpr size_t kHeaderSize = internal::align_up(sizeof(Header), internal::kMinAlignment);
+  static constexpr size_t kChunkCapacity = PageTraits::kChunkSize - kHeaderSize;
+
+  [[gnu::noinline]] void* allocate_slow(size_t size, size_t alignment) noexcept {
+    if (alignment > kChunkCapacity || size > kChunkCapacity - alignment) {
+      return allocate_oversized(size, alignment);
+    }
+
+    void* chunk = Heap::request_chunk();
+    if (chunk == nullptr) [[unlikely]] {
+      return nullptr;
+    }
+    chunks_ = new (chunk) Header{chunks_, 0};
+    if (tail_ == nullptr) {
+      tail_ = chunks_;
+    }
+    ++chunk_count_;
+
+    // The rest of the previous chunk is abandoned
+    char* base = static_cast<char*>(chunk);
+    const uintptr_t ptr =
+        internal::align_up(reinterpret_cast<uintptr_t>(base + kHeaderSize), uintptr_t{alignment});
+    cursor_ = reinterpret_cast<char*>(ptr + size);
+    end_ = base + PageTraits::kChunkSize;
+    return reinterpret_cast<void*>(ptr);
+  }
+
+  void* allocate_oversized(size_t size, size_t alignment) noexcept {
+    constexpr size_t kMaxSize = std::numeric_limits<size_t>::max() / 2;
+    if (size > kMaxSize || alignment > kMaxSize) [[unlikely]] {
+      return nullptr;
+    }
+    const size_t mapping_size =
+        internal::align_up(kHeaderSize + size + alignment, PageTraits::kRegularPageSize);
+    void* raw = HugepageProvider::allocate_large(mapping_size);
+    if (raw == nullptr) [[unlikely]] {
+      return nullptr;
+    }
+    oversized_ = new (raw) Header{oversized_, mapping_size};
+    return reinterpret_cast<void*>(internal::align_up(
+        reinterpret_cast<uintptr_t>(raw) + kHeaderSize, uintptr_t{alignment}));
+  }
+
+  void release_oversized() noexcept {
+    while (oversized_ != nullptr) {
+      Header* next = oversized_->next;
+      HugepageProvider::deallocate_large(oversized_, oversized_->size);
+      oversized_ = next;
+    }
+  }
+
+  void swap(Region& other) noexcept {
+    std::swap(cursor_, other.cursor_);
+    std::swap(end_, other.end_);
+    std::swap(chunks_, other.chunks_);
+    std::swap(tail_, other.tail_);
+    std::swap(oversized_, other.oversized_);
+    std::swap(chunk_count_, other.chunk_count_);
+  }
+
+  char* cursor_{nullptr};
+  char* end_{nullptr};
+  Header* chunks_{nullptr};  // Newest chunk, linked to older ones
+  Header* tail_{nullptr};    // Oldest chunk
+  Header* oversized_{nullptr};
+  size_t chunk_count_{0};
+};
+
+// STL allocator over a Region, rebindable like NexusAllocator. deallocate() is a no-op: the
+// container's memory is reclaimed in bulk by Region::reset() or release(), which must not run
+// while the container is still in use.
+template <typename T>
+class RegionAllocator {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  explicit RegionAllocator(Region& region) noexcept : region_(&region) {}
+
+  template <typename U>
+  RegionAllocator(const RegionAllocator<U>& other) noexcept : region_(other.region()) {}
+
+  [[nodiscard]] T* allocate(size_type n) {
+    if (n > std::numeric_limits<size_type>::max() / sizeof(T)) [[unlikely]] {
+      throw std::bad_array_new_length();
+    }
+
+    void* ptr = region_->allocate(n * sizeof(T), alignof(T));
+    if (ptr == nullptr) [[unlikely]] {
+      throw std::bad_alloc();
+    }
+
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T*, size_type) noexcept {}
+
+  [[nodiscard]] Region* region() const noexcept { return region_; }
+
+ private:
+  Region* region_;
+};
+
+template <typename T, typename U>
+bool operator==(const RegionAllocator<T>& a, const RegionAllocator<U>& b) noexcept {
+  return a.region() == b.region();
+}
+
+template <typename T, typename U>
+bool operator!=(const RegionAllocator<T>& a, const RegionAllocator<U>& b) noexcept {
+  return a.region() != b.region();
+}
+
+}  // namespace nexusalloc
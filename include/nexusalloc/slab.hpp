@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cstddef>
 
 #include "nexusalloc/hugepage_provider.hpp"
@@ -27,21 +30,26 @@ class Slab {
  public:
   static constexpr size_t kBlockSize = BlockSize;
   static constexpr size_t kChunkSize = PageTraits::kChunkSize;
-  static constexpr size_t kBlocksPerSlab = kChunkSize / kBlockSize;
-
-  explicit Slab(void* chunk) noexcept : base_(chunk) {
+  static constexpr size_t kBlocksPerSlab = kChunkSize / kBlockSize;  // Of an uncolored slab
+
+  // Cache coloring: the block array starts `color` steps into the chunk, so block 0 of slabs of
+  // different classes (all chunk-aligned) falls in different cache sets. Steps are cache lines,
+  // or the block size for power-of-two classes, whose blocks stay aligned to their size. Colors
+  // span one page, the range of L1 set indices, so at most a page per chunk is given up.
+  static constexpr size_t kColorStep =
+      std::has_single_bit(kBlockSize) ? std::max(kBlockSize, kCacheLineSize) : kCacheLineSize;
+  static constexpr size_t kColors = std::max<size_t>(PageTraits::kRegularPageSize / kColorStep, 1);
+
+  // Blocks that were never handed out are carved from a bump region instead of being threaded
+  // onto the free list up front, so constructing a slab touches none of the chunk's pages and a
+  // lazily populated chunk only faults in the pages actually used. `color` wraps at kColors.
+  explicit Slab(void* chunk, size_t color = 0) noexcept : base_(chunk) {
     if (chunk == nullptr) return;
 
-    char* ptr = static_cast<char*>(chunk);
-    for (size_t i = 0; i < kBlocksPerSlab - 1; ++i) {
-      void** block = reinterpret_cast<void**>(ptr + i * kBlockSize);
-      *block = ptr + (i + 1) * kBlockSize;  // Point to next block
-    }
-    // Last block points to nullptr
-    void** last_block = reinterpret_cast<void**>(ptr + (kBlocksPerSlab - 1) * kBlockSize);
-    *last_block = nullptr;
-
-    free_head_ = chunk;
+    const size_t offset = (color % kColors) * kColorStep;
+    capacity_ = (kChunkSize - offset) / kBlockSize;
+    bump_ = static_cast<char*>(chunk) + offset;
+    bump_end_ = bump_ + capacity_ * kBlockSize;
   }
 
   ~Slab() = default;
@@ -53,17 +61,20 @@ class Slab {
   Slab& operator=(Slab&&) = delete;
 
   [[nodiscard, gnu::hot]] void* allocate() noexcept {
-    if (free_head_ == nullptr) [[unlikely]] {
-      return nullptr;
-    }
-
     void* block = free_head_;
-    void* next = *static_cast<void**>(block);
-    if (next != nullptr) [[likely]] {
-      prefetch_read(next);  // prefetch the next block for bursty allocations
+    if (block != nullptr) [[likely]] {
+      void* next = *static_cast<void**>(block);
+      if (next != nullptr) [[likely]] {
+        prefetch_read(next);  // prefetch the next block for bursty allocations
+      }
+      free_head_ = next;
+    } else if (bump_ != bump_end_) {
+      block = bump_;
+      bump_ += kBlockSize;
+    } else [[unlikely]] {
+      return nullptr;
     }
 
-    free_head_ = next;
     ++allocated_count_;
 
 #ifndef NDEBUG
@@ -74,6 +85,62 @@ class Slab {
     return block;
   }
 
+  // Take up to `n` blocks in one pass: a run popped off the free list, then a contiguous run
+  // carved from the bump region. Returns the number of blocks written to `out`.
+  [[nodiscard]] size_t allocate_batch(void** out, size_t n) noexcept {
+    size_t count = 0;
+    void* block = free_head_;
+    while (count < n && block != nullptr) {
+      void* next = *static_cast<void**>(block);
+      if (next != nullptr) [[likely]] {
+        prefetch_read(next);
+      }
+      out[count++] = block;
+      block = next;
+    }
+    free_head_ = block;
+
+    const size_t bump_blocks =
+        std::min(n - count, static_cast<size_t>(bump_end_ - bump_) / kBlockSize);
+    for (size_t i = 0; i < bump_blocks; ++i) {
+      out[count++] = bump_ + i * kBlockSize;
+    }
+    bump_ += bump_blocks * kBlockSize;
+
+    allocated_count_ += count;
+#ifndef NDEBUG
+    for (size_t i = 0; i < count; ++i) {
+      occupancy_.set(block_index(out[i]));
+    }
+#endif
+    return count;
+  }
+
+  // Return a run of blocks with a single splice onto the free list. Every pointer must be a
+  // live block of this slab.
+  void deallocate_batch(void* const* ptrs, size_t n) noexcept {
+    if (n == 0) [[unlikely]] {
+      return;
+    }
+
+    constexpr size_t kPrefetchDistance = 8;
+    for (size_t i = 0; i + 1 < n; ++i) {
+      if (i + kPrefetchDistance < n) {
+        prefetch_write(ptrs[i + kPrefetchDistance]);  // Its link is written a few blocks later
+      }
+      *static_cast<void**>(ptrs[i]) = ptrs[i + 1];
+    }
+    *static_cast<void**>(ptrs[n - 1]) = free_head_;
+    free_head_ = ptrs[0];
+    allocated_count_ -= n;
+
+#ifndef NDEBUG
+    for (size_t i = 0; i < n; ++i) {
+      occupancy_.clear(block_index(ptrs[i]));
+    }
+#endif
+  }
+
   [[gnu::hot]] void deallocate(void* ptr) noexcept {
     if (ptr == nullptr || !contains(ptr)) [[unlikely]] {
       return;
@@ -91,11 +158,13 @@ class Slab {
 
   [[nodiscard]] bool empty() const noexcept { return allocated_count_ == 0; }
 
-  [[nodiscard]] bool full() const noexcept { return free_head_ == nullptr; }
+  [[nodiscard]] bool full() const noexcept {
+    return free_head_ == nullptr && bump_ == bump_end_;
+  }
 
   [[nodiscard]] size_t used_blocks() const noexcept { return allocated_count_; }
 
-  [[nodiscard]] size_t free_blocks() const noexcept { return kBlocksPerSlab - allocated_count_; }
+  [[nodiscard]] size_t free_blocks() const noexcept { return capacity_ - allocated_count_; }
 
   [[nodiscard]] bool contains(const void* ptr) const noexcept {
     const char* p = static_cast<const char*>(ptr);
@@ -105,6 +174,23 @@ class Slab {
 
   [[nodiscard]] void* base() const noexcept { return base_; }
 
+  // Call `fn(block)` for every allocated block, in address order. The free list is inverted into
+  // a bitmap on the stack (1 bit per block, at most 16KB), so the walk reads the free blocks'
+  // links but allocates nothing.
+  template <typename Fn>
+  void for_each_live_block(Fn&& fn) const {
+    if (allocated_count_ == 0) return;
+    char* const blocks = bump_end_ - capacity_ * kBlockSize;
+    const size_t carved = static_cast<size_t>(bump_ - blocks) / kBlockSize;
+    Bitmap<kBlocksPerSlab> live;
+    live.set_range(0, carved);
+    for (void* block = free_head_; block != nullptr; block = *static_cast<void**>(block)) {
+      live.clear(static_cast<size_t>(static_cast<char*>(block) - blocks) / kBlockSize);
+    }
+    live.for_each_set([&](size_t idx) { fn(static_cast<void*>(blocks + idx * kBlockSize)); },
+                      carved);
+  }
+
 #ifndef NDEBUG
   [[nodiscard]] const Bitmap<kBlocksPerSlab>& occupancy() const noexcept { return occupancy_; }
 #endif
@@ -118,6 +204,9 @@ class Slab {
 
   void* base_{nullptr};
   void* free_head_{nullptr};
+  char* bump_{nullptr};      // Next never-allocated block
+  char* bump_end_{nullptr};  // End of the last whole block in the chunk
+  size_t capacity_{0};       // Blocks in the chunk after the color offset
   size_t allocated_count_{0};
 
 #ifndef NDEBUG
@@ -127,6 +216,169 @@ class Slab {
 #endif
 };
 
+// Alternative slab engine that tracks blocks in a bitmap instead of an intrusive free list. Every
+// allocation takes the lowest free block, so reuse is address-ordered and objects allocated
+// together sit together, batches are carved as contiguous runs, and blocks are never written for
+// metadata. The bitmap lives with the slab object, 1 bit per block (16KB for the 16-byte class),
+// plus 1 bit per 64 blocks marking the full words searches can skip.
+// Heaps use it instead of Slab when built with NEXUSALLOC_BITMAP_SLABS.
+template <size_t BlockSize>
+class BitmapSlab {
+  static_assert(BlockSize >= 16, "BlockSize must be at least 16 for alignment");
+  static_assert(BlockSize % 16 == 0, "BlockSize must be a multiple of 16");
+
+ public:
+  static constexpr size_t kBlockSize = BlockSize;
+  static constexpr size_t kChunkSize = PageTraits::kChunkSize;
+  static constexpr size_t kBlocksPerSlab = Slab<BlockSize>::kBlocksPerSlab;
+  static constexpr size_t kColorStep = Slab<BlockSize>::kColorStep;
+  static constexpr size_t kColors = Slab<BlockSize>::kColors;
+
+  explicit BitmapSlab(void* chunk, size_t color = 0) noexcept : base_(chunk) {
+    if (chunk == nullptr) return;
+
+    const size_t offset = (color % kColors) * kColorStep;
+    capacity_ = (kChunkSize - offset) / kBlockSize;
+    blocks_ = static_cast<char*>(chunk) + offset;
+    used_.set_range(capacity_, kBlocksPerSlab);  // Past the end: never free
+    mark_full_words(capacity_, kBlocksPerSlab);
+  }
+
+  ~BitmapSlab() = default;
+
+  // Non-copyable, non-movable
+  BitmapSlab(const BitmapSlab&) = delete;
+  BitmapSlab& operator=(const BitmapSlab&) = delete;
+  BitmapSlab(BitmapSlab&&) = delete;
+  BitmapSlab& operator=(BitmapSlab&&) = delete;
+
+  [[nodiscard, gnu::hot]] void* allocate() noexcept {
+    const size_t idx = find_free(hint_);
+    if (idx >= capacity_) [[unlikely]] {
+      hint_ = capacity_;
+      return nullptr;
+    }
+    used_.set(idx);
+    if (used_.word(idx / kBitsPerWord) == kAllOnes) full_words_.set(idx / kBitsPerWord);
+    hint_ = idx + 1;
+    ++allocated_count_;
+    return blocks_ + idx * kBlockSize;
+  }
+
+  // Take up to `n` blocks as runs of adjacent free blocks, lowest addresses first. Returns the
+  // number of blocks written to `out`.
+  [[nodiscard]] size_t allocate_batch(void** out, size_t n) noexcept {
+    size_t count = 0;
+    size_t start = find_free(hint_);
+    while (count < n && start < capacity_) {
+      const size_t end = std::min(used_.find_first_set_from(start), start + (n - count));
+      used_.set_range(start, end);
+      mark_full_words(start, end);
+      for (size_t idx = start; idx < end; ++idx) {
+        out[count++] = blocks_ + idx * kBlockSize;
+      }
+      start = end < capacity_ ? find_free(end) : capacity_;
+    }
+    hint_ = start;
+    allocated_count_ += count;
+    return count;
+  }
+
+  // Every pointer must be a live block of this slab
+  void deallocate_batch(void* const* ptrs, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+      release(block_index(ptrs[i]));
+    }
+    allocated_count_ -= n;
+  }
+
+  [[gnu::hot]] void deallocate(void* ptr) noexcept {
+    if (ptr == nullptr || !contains(ptr)) [[unlikely]] {
+      return;
+    }
+    release(block_index(ptr));
+    --allocated_count_;
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return allocated_count_ == 0; }
+  [[nodiscard]] bool full() const noexcept { return allocated_count_ == capacity_; }
+  [[nodiscard]] size_t used_blocks() const noexcept { return allocated_count_; }
+  [[nodiscard]] size_t free_blocks() const noexcept { return capacity_ - allocated_count_; }
+
+  [[nodiscard]] bool contains(const void* ptr) const noexcept {
+    const char* p = static_cast<const char*>(ptr);
+    const char* base = static_cast<const char*>(base_);
+    return p >= base && p < base + kChunkSize;
+  }
+
+  [[nodiscard]] void* base() const noexcept { return base_; }
+
+  // Call `fn(block)` for every allocated block, in address order, straight from the bitmap
+  template <typename Fn>
+  void for_each_live_block(Fn&& fn) const {
+    if (allocated_count_ == 0) return;
+    used_.for_each_set([&](size_t idx) { fn(static_cast<void*>(blocks_ + idx * kBlockSize)); },
+                       capacity_);
+  }
+
+  // Set bits are blocks in use, relative to the first block; bits from the capacity on are set
+  [[nodiscard]] const Bitmap<kBlocksPerSlab>& occupancy() const noexcept { return used_; }
+
+ private:
+  [[nodiscard]] size_t block_index(const void* ptr) const noexcept {
+    return static_cast<size_t>(static_cast<const char*>(ptr) - blocks_) / kBlockSize;
+  }
+
+  static constexpr size_t kBitsPerWord = Bitmap<kBlocksPerSlab>::kBitsPerWord;
+  static constexpr size_t kNumWords = Bitmap<kBlocksPerSlab>::kNumWords;
+  static constexpr uint64_t kAllOnes = ~uint64_t{0};
+
+  // Lowest free block at or after `start`: the summary skips full words 64 at a time, so a
+  // search over a mostly full slab reads a few words instead of the whole bitmap
+  [[nodiscard]] size_t find_free(size_t start) const noexcept {
+    if (start >= kBlocksPerSlab) return kBlocksPerSlab;
+    size_t word_idx = start / kBitsPerWord;
+    uint64_t bits = ~used_.word(word_idx) & (kAllOnes << (start % kBitsPerWord));
+    if (bits == 0) {
+      word_idx = full_words_.find_first_clear_from(word_idx + 1);
+      if (word_idx >= kNumWords) return kBlocksPerSlab;
+      bits = ~used_.word(word_idx);
+    }
+    return word_idx * kBitsPerWord + static_cast<size_t>(std::countr_zero(bits));
+  }
+
+  // Flag the now full words among those holding blocks [begin, end), end <= kBlocksPerSlab
+  void mark_full_words(size_t begin, size_t end) noexcept {
+    const size_t last = (end + kBitsPerWord - 1) / kBitsPerWord;
+    for (size_t w = begin / kBitsPerWord; w < last && w < kNumWords; ++w) {
+      if (used_.word(w) == kAllOnes) full_words_.set(w);
+    }
+  }
+
+  void release(size_t idx) noexcept {
+    used_.clear(idx);
+    full_words_.clear(idx / kBitsPerWord);
+    hint_ = std::min(hint_, idx);
+  }
+
+  void* base_{nullptr};
+  char* blocks_{nullptr};
+  size_t capacity_{0};
+  size_t hint_{0};  // No free block below this index
+  size_t allocated_count_{0};
+  Bitmap<kNumWords> full_words_;  // Bit w set when word w of used_ has no free block
+  Bitmap<kBlocksPerSlab> used_;
+};
+
+// Engine behind SlabWrapper, and so behind every heap
+#ifdef NEXUSALLOC_BITMAP_SLABS
+template <size_t BlockSize>
+using SlabEngine = BitmapSlab<BlockSize>;
+#else
+template <size_t BlockSize>
+using SlabEngine = Slab<BlockSize>;
+#endif
+
 // Map size class index to block size at compile time
 template <size_t ClassIndex>
 struct SizeClassToBlockSize;
@@ -150,22 +402,22 @@ inline constexpr size_t kBlockSizeForClass = SizeClassToBlockSize<ClassIndex>::v
 
 // Macro to generate switch cases for all size classes
 // This generates optimal jump-table code that the compiler can fully inline
-#define NEXUS_DISPATCH_CASE(idx, slab_ptr, op)                       \
-  case idx: {                                                        \
-    auto* s = static_cast<Slab<kBlockSizeForClass<idx>>*>(slab_ptr); \
-    return s->op;                                                    \
+#define NEXUS_DISPATCH_CASE(idx, slab_ptr, op)                             \
+  case idx: {                                                              \
+    auto* s = static_cast<SlabEngine<kBlockSizeForClass<idx>>*>(slab_ptr); \
+    return s->op;                                                          \
   }
 
-#define NEXUS_CREATE_CASE(idx, chunk)                     \
-  case idx: {                                             \
-    slab_ptr_ = new Slab<kBlockSizeForClass<idx>>(chunk); \
-    return;                                               \
+#define NEXUS_CREATE_CASE(idx, chunk, color)                           \
+  case idx: {                                                          \
+    slab_ptr_ = new SlabEngine<kBlockSizeForClass<idx>>(chunk, color); \
+    return;                                                            \
   }
 
-#define NEXUS_DESTROY_CASE(idx, slab_ptr_)                         \
-  case idx: {                                                      \
-    delete static_cast<Slab<kBlockSizeForClass<idx>>*>(slab_ptr_); \
-    break;                                                         \
+#define NEXUS_DESTROY_CASE(idx, slab_ptr_)                               \
+  case idx: {                                                            \
+    delete static_cast<SlabEngine<kBlockSizeForClass<idx>>*>(slab_ptr_); \
+    break;                                                               \
   }
 
 // clang-format off
@@ -246,6 +498,24 @@ class SlabWrapper {
     }
   }
 
+  [[nodiscard]] size_t allocate_batch(void** out, size_t n) noexcept {
+    if (slab_ptr_ == nullptr) [[unlikely]] return 0;
+    switch (class_idx_) {
+      NEXUS_GENERATE_ALL_CASES(NEXUS_DISPATCH_CASE, slab_ptr_, allocate_batch(out, n))
+      default:
+        return 0;
+    }
+  }
+
+  void deallocate_batch(void* const* ptrs, size_t n) noexcept {
+    if (slab_ptr_ == nullptr) [[unlikely]] return;
+    switch (class_idx_) {
+      NEXUS_GENERATE_ALL_CASES(NEXUS_DISPATCH_CASE, slab_ptr_, deallocate_batch(ptrs, n))
+      default:
+        return;
+    }
+  }
+
   [[nodiscard]] bool empty() const noexcept {
     if (slab_ptr_ == nullptr) return true;
     switch (class_idx_) {
@@ -264,6 +534,24 @@ class SlabWrapper {
     }
   }
 
+  [[nodiscard]] size_t free_blocks() const noexcept {
+    if (slab_ptr_ == nullptr) return 0;
+    switch (class_idx_) {
+      NEXUS_GENERATE_ALL_CASES(NEXUS_DISPATCH_CASE, slab_ptr_, free_blocks())
+      default:
+        return 0;
+    }
+  }
+
+  [[nodiscard]] size_t used_blocks() const noexcept {
+    if (slab_ptr_ == nullptr) return 0;
+    switch (class_idx_) {
+      NEXUS_GENERATE_ALL_CASES(NEXUS_DISPATCH_CASE, slab_ptr_, used_blocks())
+      default:
+        return 0;
+    }
+  }
+
   [[nodiscard]] bool contains(const void* ptr) const noexcept {
     if (slab_ptr_ == nullptr) return false;
     switch (class_idx_) {
@@ -282,10 +570,24 @@ class SlabWrapper {
     }
   }
 
+  // Call `fn(block)` for every allocated block of the slab, in address order
+  template <typename Fn>
+  void for_each_live_block(Fn&& fn) const {
+    if (slab_ptr_ == nullptr) return;
+    switch (class_idx_) {
+      NEXUS_GENERATE_ALL_CASES(NEXUS_DISPATCH_CASE, slab_ptr_, for_each_live_block(fn))
+      default:
+        return;
+    }
+  }
+
  private:
+  // Colors rotate across all slabs created, whatever their class or heap, so slabs created back
+  // to back start in different cache sets
   void create_slab(void* chunk) noexcept {
+    const size_t color = next_color_.fetch_add(1, std::memory_order_relaxed);
     switch (class_idx_) {
-      NEXUS_GENERATE_ALL_CASES(NEXUS_CREATE_CASE, chunk)
+      NEXUS_GENERATE_ALL_CASES(NEXUS_CREATE_CASE, chunk, color)
       default:
         return;
     }
@@ -303,6 +605,8 @@ class SlabWrapper {
 
   void* slab_ptr_{nullptr};
   size_t class_idx_{0};
+
+  static inline std::atomic<size_t> next_color_{0};
 };
 
 #undef NEXUS_DISPATCH_CASE
@@ -313,5 +617,6 @@ class SlabWrapper {
 }  // namespace nexusalloc::internal
 
 namespace nexusalloc {
+using internal::BitmapSlab;
 using internal::Slab;
 }
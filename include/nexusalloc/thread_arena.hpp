@@ -1,179 +1,197 @@
 #pragma once
 
-#include <array>
+#include <pthread.h>
+
+#include <atomic>
 #include <cstddef>
-#include <vector>
+#include <cstdlib>
+#include <mutex>
+#include <new>
 
-#include "nexusalloc/atomic_stack.hpp"
-#include "nexusalloc/hugepage_provider.hpp"
-#include "nexusalloc/internal/alignment.hpp"
-#include "nexusalloc/internal/size_class.hpp"
-#include "nexusalloc/slab.hpp"
+#include "nexusalloc/heap.hpp"
 
 namespace nexusalloc {
 
-// Thread-local arena for fast-path allocations
-// Each thread has its own arena with slabs for each size class
-class ThreadArena {
- public:
-  // Thread-local singleton instance
-  static ThreadArena& get() noexcept {
-    thread_local ThreadArena arena;
-    return arena;
-  }
-
-  [[nodiscard, gnu::hot]] void* allocate(size_t size) noexcept {
-    // Treat size 0 as minimum allocation (matches jemalloc behavior)
-    // SizeClass::index(0) returns 0, which maps to 16 bytes
+class ThreadArena;
 
-    if (internal::SizeClass::is_large(size)) [[unlikely]] {
-      return allocate_large(size);
-    }
+namespace internal {
 
-    size_t class_idx = internal::SizeClass::index(size);
-    auto& bin = bins_[class_idx];
+// The calling thread's live ThreadArena, or nullptr before its first get() and after thread exit.
+// A trivially-initialized initial-exec pointer: reading it is a single %fs-relative load, with no
+// TLS init guard and no __tls_get_addr call even when nexusalloc is linked into a shared library
+// (the TlsModel tests build one and check its imports).
+// Initial-exec TLS comes from the static TLS block, which a library loaded with dlopen() can only
+// use sparingly; one pointer fits.
+inline __thread ThreadArena* tls_arena [[gnu::tls_model("initial-exec")]] = nullptr;
 
-    // Fast path: try current slab (this is the only code that gets inlined aggressively)
-    if (bin.current_slab.valid()) [[likely]] {
-      void* ptr = bin.current_slab.allocate();
-      if (ptr != nullptr) [[likely]] {
-        return ptr;
-      }
-    }
+// Reserves the word AtomicStack links through while an arena is parked
+struct ArenaPoolLink {
+  void* next{nullptr};
+};
 
-    // Slow path: current slab is full or doesn't exist - not inlined to reduce code size and keep
-    // hot code in the I-cache
-    return allocate_slow(class_idx, bin);
-  }
+}  // namespace internal
 
-  [[gnu::hot]] void deallocate(void* ptr, size_t size) noexcept {
-    if (ptr == nullptr) [[unlikely]]
-      return;
-
-    if (internal::SizeClass::is_large(size)) [[unlikely]] {
-      deallocate_large(ptr, size);
-      return;
+// Thread-local arena for fast-path allocations
+// Each thread has its own heap with slabs for each size class. The arena is bound by the first
+// get() on a thread and released by a pthread key destructor when the thread exits, after the
+// thread's C++ thread_local destructors, so those may still free memory into it.
+//
+// Released arenas are parked whole, slabs and free lists included, in a lock-free pool of up to
+// pool_limit() arenas, and the next new thread adopts one instead of building its slabs from
+// scratch. Blocks the exited thread left allocated stay valid and belong to the adopter.
+class ThreadArena : private internal::ArenaPoolLink, public Heap {
+ public:
+  // Thread-local singleton instance
+  [[gnu::always_inline]] static ThreadArena& get() noexcept {
+    ThreadArena* arena = internal::tls_arena;
+    if (arena != nullptr) [[likely]] {
+      return *arena;
     }
+    return create();
+  }
 
-    size_t class_idx = internal::SizeClass::index(size);
-    auto& bin = bins_[class_idx];
-    void* slab_base = internal::slab_base_from_ptr(ptr);
-
-    // Fast path: deallocate to current slab (this is the only code that gets inlined)
-    if (bin.current_slab.valid() && bin.current_slab.base() == slab_base) [[likely]] {
-      bin.current_slab.deallocate(ptr);
-      return;
-    }
+  // The calling thread's arena if get() already created it, else nullptr. Never constructs one,
+  // so it is a single TLS load.
+  [[nodiscard]] static ThreadArena* current() noexcept { return internal::tls_arena; }
 
-    // Slow path: pointer belongs to partial or full slab - not inlined to reduce code size and keep
-    // hot code in the I-cache
-    deallocate_slow(ptr, slab_base, bin);
+  // Most arenas kept parked for reuse; beyond it exiting threads' arenas are destroyed.
+  // Config::kUnlimited parks every one. Until set explicitly, or after reset_pool_limit(),
+  // NEXUSALLOC_CONF's arena_pool. Lowering it does not evict parked arenas.
+  static void set_pool_limit(size_t limit) noexcept {
+    pool_limit_.store(limit, std::memory_order_relaxed);
   }
 
-  ~ThreadArena() {
-    for (auto& bin : bins_) {
-      if (bin.current_slab.valid()) {
-        return_chunk(bin.current_slab.base());
-      }
-      for (auto& slab : bin.partial_slabs) {
-        return_chunk(slab.base());
-      }
-      for (auto& slab : bin.full_slabs) {
-        return_chunk(slab.base());
-      }
-    }
+  static void reset_pool_limit() noexcept {
+    pool_limit_.store(kUnsetLimit, std::memory_order_relaxed);
   }
 
- private:
-  struct alignas(internal::kCacheLineSize) SizeClassBin {
-    internal::SlabWrapper current_slab{};
-    std::vector<internal::SlabWrapper> partial_slabs;
-    std::vector<internal::SlabWrapper> full_slabs;
-  };
-  std::array<SizeClassBin, internal::SizeClass::kNumClasses> bins_;
-
-  [[nodiscard, gnu::noinline, gnu::cold]]
-  void* allocate_slow(size_t class_idx, SizeClassBin& bin) noexcept {
-    // Move current slab to full list if it exists and is full
-    if (bin.current_slab.valid()) {
-      bin.full_slabs.push_back(std::move(bin.current_slab));
-      bin.current_slab = internal::SlabWrapper{};
-    }
+  [[nodiscard]] static size_t pool_limit() noexcept {
+    const size_t value = pool_limit_.load(std::memory_order_relaxed);
+    return value == kUnsetLimit ? config().arena_pool : value;
+  }
 
-    // Try partial slabs
-    if (!bin.partial_slabs.empty()) {
-      bin.current_slab = std::move(bin.partial_slabs.back());
-      bin.partial_slabs.pop_back();
-      return bin.current_slab.allocate();
+  [[nodiscard]] static size_t parked_count() noexcept { return pool().approximate_size(); }
+
+  // Call `fn(arena)` for every arena, bound to a live thread or parked. Arenas are neither created
+  // nor destroyed meanwhile, so `fn` must not allocate on a thread that has no arena yet. Reading
+  // another thread's arena is only safe while that thread does not allocate or free.
+  template <typename Fn>
+  static void for_each_arena(Fn&& fn) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (ThreadArena* arena = reg.head; arena != nullptr; arena = arena->next_registered_) {
+      fn(*arena);
     }
+  }
 
-    // Need a new chunk
-    void* chunk = request_chunk();
-    if (chunk == nullptr) {
-      return nullptr;  // Out of memory
+  // Destroy every parked arena, returning its chunks to global_page_stack(). Returns the number
+  // of arenas destroyed.
+  static size_t release_parked() noexcept {
+    size_t released = 0;
+    while (ThreadArena* arena = unpark()) {
+      pool().quiesce();  // Another unpark() may still be reading its link
+      delete arena;
+      ++released;
     }
+    return released;
+  }
 
-    // Create new slab for this size class using compile-time dispatch
-    bin.current_slab = internal::SlabWrapper(class_idx, chunk);
-    return bin.current_slab.allocate();
+ private:
+  ThreadArena() noexcept : Heap(SharedLargeTag{}) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    next_registered_ = reg.head;
+    if (reg.head != nullptr) reg.head->prev_registered_ = this;
+    reg.head = this;
   }
 
-  [[gnu::noinline, gnu::cold]]
-  void deallocate_slow(void* ptr, void* slab_base, SizeClassBin& bin) noexcept {
-    // Search partial slabs
-    for (auto& slab : bin.partial_slabs) {
-      if (slab.base() == slab_base) {
-        slab.deallocate(ptr);
-        return;
-      }
+  ~ThreadArena() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (prev_registered_ != nullptr) {
+      prev_registered_->next_registered_ = next_registered_;
+    } else {
+      reg.head = next_registered_;
     }
+    if (next_registered_ != nullptr) next_registered_->prev_registered_ = prev_registered_;
+  }
 
-    // Search full slabs
-    for (size_t i = 0; i < bin.full_slabs.size(); ++i) {
-      if (bin.full_slabs[i].base() == slab_base) {
-        bin.full_slabs[i].deallocate(ptr);
-        // Move to partial list since it now has free blocks
-        bin.partial_slabs.push_back(std::move(bin.full_slabs[i]));
-        bin.full_slabs.erase(bin.full_slabs.begin() + static_cast<ptrdiff_t>(i));
-        return;
+  [[gnu::noinline, gnu::cold]] static ThreadArena& create() noexcept {
+    const pthread_key_t key = exit_key();
+    ThreadArena* arena = unpark();
+    if (arena != nullptr) {
+      // Drop the last owner's tuning
+      arena->set_empty_slab_limit(config().thread_cache_slabs);
+      arena->set_byte_budget(config().thread_cache_bytes);
+      arena->set_slab_selection(SlabSelection::kFullest);
+    } else {
+      arena = new (std::nothrow) ThreadArena;
+      if (arena == nullptr) [[unlikely]] {
+        std::abort();  // No arena to fall back on: every allocation on this thread needs one
       }
     }
+    // Bound before registering: a failed registration only leaks the arena at thread exit
+    internal::tls_arena = arena;
+    pthread_setspecific(key, arena);
+    return *arena;
+  }
 
-    // Pointer not found - undefined behavior, silently ignore
+  // Created once per process; the key itself is never deleted
+  [[nodiscard]] static pthread_key_t exit_key() noexcept {
+    static const pthread_key_t key = [] {
+      pthread_key_t k{};
+      pthread_key_create(&k, &destroy);
+      return k;
+    }();
+    return key;
   }
 
-  ThreadArena() = default;
+  // Key destructor. If a later destructor allocates again, create() builds a fresh arena and
+  // re-registers it, and pthread runs this once more (up to PTHREAD_DESTRUCTOR_ITERATIONS).
+  static void destroy(void* arena) noexcept {
+    internal::tls_arena = nullptr;
+    park(static_cast<ThreadArena*>(arena));
+  }
 
-  // Request a new chunk from the global pool or OS
-  [[nodiscard]] void* request_chunk() noexcept {
-    void* chunk = global_page_stack().pop();
-    if (chunk != nullptr) [[likely]] {
-      return chunk;
+  // The limit is checked before the push, so racing exits may overshoot it by a few arenas
+  static void park(ThreadArena* arena) noexcept {
+    if (pool().approximate_size() >= pool_limit()) {
+      pool().quiesce();  // It may have been parked before
+      delete arena;
+      return;
     }
-
-    return HugepageProvider::allocate_chunk();
+    pool().push(static_cast<internal::ArenaPoolLink*>(arena));
   }
 
-  void return_chunk(void* chunk) noexcept {
-    if (chunk != nullptr) {
-      global_page_stack().push(chunk);
-    }
+  [[nodiscard]] static ThreadArena* unpark() noexcept {
+    void* link = pool().pop();
+    if (link == nullptr) return nullptr;
+    return static_cast<ThreadArena*>(static_cast<internal::ArenaPoolLink*>(link));
   }
 
-  [[nodiscard]] void* allocate_large(size_t size) noexcept {
-    size_t aligned_size = internal::align_up(size, PageTraits::kRegularPageSize);
-    void* ptr =
-        mmap(nullptr, aligned_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    if (ptr == MAP_FAILED) {
-      return nullptr;
-    }
-    return ptr;
+  static AtomicStack& pool() noexcept {
+    static AtomicStack stack;
+    return stack;
   }
 
-  void deallocate_large(void* ptr, size_t size) noexcept {
-    size_t aligned_size = internal::align_up(size, PageTraits::kRegularPageSize);
-    munmap(ptr, aligned_size);
+  // Every arena that exists, linked through the arenas themselves
+  struct Registry {
+    std::mutex mutex;
+    ThreadArena* head{nullptr};
+  };
+
+  // Never destroyed, so threads exiting during static destruction can still unlink their arenas
+  [[nodiscard]] static Registry& registry() noexcept {
+    alignas(Registry) static unsigned char storage[sizeof(Registry)];
+    static Registry* reg = new (storage) Registry;
+    return *reg;
   }
+
+  static constexpr size_t kUnsetLimit = Config::kUnlimited - 2;  // NEXUSALLOC_CONF applies
+  static inline std::atomic<size_t> pool_limit_{kUnsetLimit};
+
+  ThreadArena* prev_registered_{nullptr};
+  ThreadArena* next_registered_{nullptr};
 };
 
 }  // namespace nexusalloc
@@ -0,0 +1,17 @@
+# Fails unless LIBRARY's dynamic symbol table imports __tls_get_addr exactly when
+# EXPECT_TLS_GET_ADDR is true. Run by CTest with -DNM=... -DLIBRARY=... -DEXPECT_TLS_GET_ADDR=...
+execute_process(
+    COMMAND ${NM} -D --undefined-only ${LIBRARY}
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${LIBRARY}")
+endif()
+
+string(FIND "${symbols}" "__tls_get_addr" found)
+if(EXPECT_TLS_GET_ADDR AND found EQUAL -1)
+    message(FATAL_ERROR "${LIBRARY} does not import __tls_get_addr")
+elseif(NOT EXPECT_TLS_GET_ADDR AND NOT found EQUAL -1)
+    message(FATAL_ERROR "${LIBRARY} imports __tls_get_addr")
+endif()
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <list>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -143,3 +145,17 @@ TEST(AllocatorTest, VectorShrinkToFit) {
   EXPECT_LE(vec.capacity(), 100);  // Should have shrunk
   EXPECT_EQ(vec.size(), 10);
 }
+
+TEST(IsolatedAllocatorTest, NodesDoNotShareCacheLines) {
+  std::list<uint64_t, IsolatedAllocator<uint64_t>> counters;
+  std::set<uintptr_t> lines;
+  for (uint64_t i = 0; i < 100; ++i) {
+    counters.push_back(i);
+    // A list node is two links and the value, well inside one line
+    lines.insert(reinterpret_cast<uintptr_t>(&counters.back()) / internal::kCacheLineSize);
+  }
+  EXPECT_EQ(lines.size(), counters.size());
+
+  IsolatedAllocator<double> rebound(counters.get_allocator());
+  EXPECT_TRUE(rebound == IsolatedAllocator<double>{});
+}
@@ -91,6 +91,105 @@ TEST(AtomicStackTest, ApproximateSize) {
   }
 }
 
+TEST(AtomicStackTest, PushChain) {
+  AtomicStack stack;
+
+  void* existing = HugepageProvider::allocate_chunk();
+  ASSERT_NE(existing, nullptr);
+  stack.push(existing);
+
+  // Link three chunks through their first word, as push() would
+  std::vector<void*> chunks;
+  for (int i = 0; i < 3; ++i) {
+    void* chunk = HugepageProvider::allocate_chunk();
+    ASSERT_NE(chunk, nullptr);
+    chunks.push_back(chunk);
+  }
+  *static_cast<void**>(chunks[0]) = chunks[1];
+  *static_cast<void**>(chunks[1]) = chunks[2];
+
+  stack.push_chain(chunks[0], chunks[2], 3);
+  EXPECT_EQ(stack.approximate_size(), 4);
+
+  // The chain sits on top in order, followed by what was already there
+  EXPECT_EQ(stack.pop(), chunks[0]);
+  EXPECT_EQ(stack.pop(), chunks[1]);
+  EXPECT_EQ(stack.pop(), chunks[2]);
+  EXPECT_EQ(stack.pop(), existing);
+  EXPECT_TRUE(stack.empty());
+
+  for (void* chunk : chunks) {
+    HugepageProvider::deallocate_chunk(chunk);
+  }
+  HugepageProvider::deallocate_chunk(existing);
+}
+
+TEST(AtomicStackTest, ApproximateSizeFollowsEveryOperation) {
+  AtomicStack stack;
+  // Nodes only need their first word for the link
+  std::vector<void*> nodes(6);
+
+  stack.push(&nodes[0]);
+  stack.push(&nodes[1]);
+  EXPECT_EQ(stack.approximate_size(), 2u);
+
+  nodes[2] = &nodes[3];
+  nodes[3] = &nodes[4];
+  stack.push_chain(&nodes[2], &nodes[4], 3);
+  EXPECT_EQ(stack.approximate_size(), 5u);
+
+  stack.push(nullptr);
+  stack.push_chain(nullptr, nullptr, 4);
+  EXPECT_EQ(stack.approximate_size(), 5u);
+
+  for (size_t left = 5; left > 0; --left) {
+    ASSERT_NE(stack.pop(), nullptr);
+    EXPECT_EQ(stack.approximate_size(), left - 1);
+  }
+  EXPECT_EQ(stack.pop(), nullptr);
+  EXPECT_EQ(stack.approximate_size(), 0u);
+}
+
+TEST(AtomicStackTest, ConcurrentPushPopKeepsSizeBalanced) {
+  AtomicStack stack;
+  constexpr int kNumThreads = 4;
+  constexpr int kNodesPerThread = 64;
+  constexpr int kRounds = 200;
+  std::vector<void*> storage(kNumThreads * kNodesPerThread);
+
+  // Each round a thread pushes its nodes (half singly, half as one chain), then pops as many
+  // nodes as it pushed, whoever's they are
+  auto worker = [&](int thread_id) {
+    void** nodes = &storage[static_cast<size_t>(thread_id) * kNodesPerThread];
+    std::vector<void*> held;
+    for (int i = 0; i < kNodesPerThread; ++i) held.push_back(&nodes[i]);
+    for (int round = 0; round < kRounds; ++round) {
+      constexpr int kHalf = kNodesPerThread / 2;
+      for (int i = 0; i < kHalf; ++i) stack.push(held[i]);
+      for (int i = kHalf; i < kNodesPerThread - 1; ++i) {
+        *static_cast<void**>(held[i]) = held[i + 1];
+      }
+      stack.push_chain(held[kHalf], held[kNodesPerThread - 1], kHalf);
+
+      held.clear();
+      while (held.size() < kNodesPerThread) {
+        if (void* node = stack.pop()) held.push_back(node);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(worker, i);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_TRUE(stack.empty());
+  EXPECT_EQ(stack.approximate_size(), 0u);
+}
+
 TEST(AtomicStackTest, ConcurrentPush) {
   AtomicStack stack;
   constexpr int kNumThreads = 4;
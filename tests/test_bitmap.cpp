@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <random>
+#include <vector>
+
 #include "nexusalloc/internal/bitmap.hpp"
 
 using namespace nexusalloc::internal;
@@ -108,3 +112,136 @@ TEST(BitmapTest, NonPowerOfTwo) {
   EXPECT_TRUE(bm.all());
   EXPECT_EQ(bm.count(), 100);
 }
+
+TEST(BitmapTest, SetAndClearRange) {
+  Bitmap<300> bm;
+  bm.set_range(10, 20);
+  EXPECT_EQ(bm.count(), 10);
+  EXPECT_FALSE(bm.test(9));
+  EXPECT_TRUE(bm.test(10));
+  EXPECT_TRUE(bm.test(19));
+  EXPECT_FALSE(bm.test(20));
+
+  // Across words, clamped at the end
+  bm.set_range(60, 1000);
+  EXPECT_EQ(bm.count(), 10 + 240);
+  EXPECT_TRUE(bm.test(299));
+
+  bm.clear_range(64, 256);
+  EXPECT_EQ(bm.count(), 10 + 4 + 44);
+  EXPECT_TRUE(bm.test(63));
+  EXPECT_FALSE(bm.test(64));
+  EXPECT_FALSE(bm.test(255));
+  EXPECT_TRUE(bm.test(256));
+
+  bm.clear_range(5, 5);
+  bm.clear_range(0, 300);
+  EXPECT_TRUE(bm.none());
+}
+
+TEST(BitmapTest, FindFirstSetAndClearFrom) {
+  Bitmap<200> bm;
+  EXPECT_EQ(bm.find_first_set_from(0), 200);
+  bm.set(3);
+  bm.set(130);
+  EXPECT_EQ(bm.find_first_set_from(0), 3);
+  EXPECT_EQ(bm.find_first_set_from(3), 3);
+  EXPECT_EQ(bm.find_first_set_from(4), 130);
+  EXPECT_EQ(bm.find_first_set_from(131), 200);
+  EXPECT_EQ(bm.find_first_set_from(500), 200);
+
+  bm.set_range(0, 200);
+  bm.clear(150);
+  EXPECT_EQ(bm.find_first_clear_from(0), 150);
+  EXPECT_EQ(bm.find_first_clear_from(151), 200);
+}
+
+TEST(BitmapTest, FindRunOfClear) {
+  Bitmap<256> bm;
+  EXPECT_EQ(bm.find_run_of_clear(256), 0);
+  EXPECT_EQ(bm.find_run_of_clear(257), 256);
+
+  bm.set(5);
+  bm.set(70);
+  EXPECT_EQ(bm.find_run_of_clear(5), 0);
+  EXPECT_EQ(bm.find_run_of_clear(6), 6);    // Run 6..69 spans a word boundary
+  EXPECT_EQ(bm.find_run_of_clear(65), 71);  // Only the tail run is long enough
+  EXPECT_EQ(bm.find_run_of_clear(186), 256);
+  EXPECT_EQ(bm.find_run_of_clear(185), 71);
+}
+
+// The slab bitmap of the 16-byte class: scans go through the SIMD kernels
+TEST(BitmapTest, ForEachSet) {
+  Bitmap<200> bm;
+  for (size_t i : {0, 5, 63, 64, 130, 150, 199}) bm.set(i);
+
+  std::vector<size_t> seen;
+  bm.for_each_set([&](size_t i) { seen.push_back(i); });
+  EXPECT_EQ(seen, (std::vector<size_t>{0, 5, 63, 64, 130, 150, 199}));
+
+  // Bits at or past `end` are skipped, including within a word
+  seen.clear();
+  bm.for_each_set([&](size_t i) { seen.push_back(i); }, 150);
+  EXPECT_EQ(seen, (std::vector<size_t>{0, 5, 63, 64, 130}));
+}
+
+TEST(BitmapTest, LargeBitmapScans) {
+  auto bm = std::make_unique<Bitmap<131072>>();
+  EXPECT_TRUE(bm->none());
+  EXPECT_EQ(bm->find_first_set_from(0), 131072);
+
+  bm->set_range(0, 131072);
+  EXPECT_TRUE(bm->all());
+  EXPECT_EQ(bm->count(), 131072);
+  EXPECT_EQ(bm->find_first_clear(), 131072);
+
+  bm->clear_range(100000, 100010);
+  EXPECT_FALSE(bm->all());
+  EXPECT_EQ(bm->count(), 131062);
+  EXPECT_EQ(bm->find_first_clear(), 100000);
+  EXPECT_EQ(bm->find_run_of_clear(10), 100000);
+  EXPECT_EQ(bm->find_run_of_clear(11), 131072);
+
+  bm->reset();
+  bm->set(131071);
+  EXPECT_FALSE(bm->none());
+  EXPECT_EQ(bm->find_first_set_from(1), 131071);
+}
+
+TEST(BitmapSimdTest, KernelsAgreeAtEverySupportedLevel) {
+  std::vector<uint64_t> words(1000);
+  std::mt19937_64 rng{7};
+  for (auto& word : words) word = rng();
+
+  const size_t expected_count = popcount_words(words.data(), words.size(),
+                                                         SimdLevel::kScalar);
+  std::vector<SimdLevel> levels{SimdLevel::kScalar};
+  if (simd_level() >= SimdLevel::kAvx2) {
+    levels.push_back(SimdLevel::kAvx2);
+  }
+  if (simd_level() >= SimdLevel::kAvx512) {
+    levels.push_back(SimdLevel::kAvx512);
+  }
+
+  for (auto level : levels) {
+    // Odd lengths exercise the scalar tails
+    for (size_t n : {0, 1, 3, 7, 9, 999, 1000}) {
+      EXPECT_EQ(popcount_words(words.data(), n, level),
+                popcount_words(words.data(), n, SimdLevel::kScalar));
+    }
+    EXPECT_EQ(popcount_words(words.data(), words.size(), level), expected_count);
+
+    std::vector<uint64_t> same(1000, ~uint64_t{0});
+    EXPECT_EQ(find_word_not_equal(same.data(), 0, same.size(), ~uint64_t{0}, level),
+              1000u);
+    for (size_t pos : {0, 3, 4, 8, 13, 500, 999}) {
+      same[pos] = 0;
+      for (size_t begin : {size_t{0}, pos / 2, pos}) {
+        EXPECT_EQ(
+            find_word_not_equal(same.data(), begin, same.size(), ~uint64_t{0}, level),
+            pos);
+      }
+      same[pos] = ~uint64_t{0};
+    }
+  }
+}
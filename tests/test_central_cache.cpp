@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+#include "nexusalloc/central_cache.hpp"
+
+using namespace nexusalloc;
+
+TEST(CentralCacheTest, PopsOnlyMatchingClassFromAnyShard) {
+  CentralCache cache;
+  std::vector<void*> chunks;
+  for (size_t shard = 0; shard < CentralCache::kShards + 1; ++shard) {
+    void* chunk = HugepageProvider::allocate_chunk();
+    ASSERT_NE(chunk, nullptr);
+    chunks.push_back(chunk);
+    internal::SlabWrapper slab(3, chunk);
+    ASSERT_TRUE(cache.push(slab, shard));
+    EXPECT_FALSE(slab.valid());
+  }
+  EXPECT_EQ(cache.slab_count(), CentralCache::kShards + 1);
+
+  EXPECT_FALSE(cache.pop(4, 0).valid());
+
+  // Pushed to shard 1, found from shard 0 as well
+  for (size_t i = 0; i < CentralCache::kShards + 1; ++i) {
+    internal::SlabWrapper slab = cache.pop(3, 0);
+    ASSERT_TRUE(slab.valid());
+    EXPECT_EQ(slab.class_index(), 3u);
+    EXPECT_TRUE(slab.empty());
+  }
+  EXPECT_FALSE(cache.pop(3, 5).valid());
+  EXPECT_EQ(cache.slab_count(), 0u);
+
+  for (void* chunk : chunks) {
+    HugepageProvider::deallocate_chunk(chunk);
+  }
+}
+
+TEST(CentralCacheTest, ReleaseHandsBackEveryChunk) {
+  CentralCache cache;
+  std::vector<void*> chunks;
+  for (size_t class_idx : {0, 7, 23}) {
+    void* chunk = HugepageProvider::allocate_chunk();
+    ASSERT_NE(chunk, nullptr);
+    chunks.push_back(chunk);
+    internal::SlabWrapper slab(class_idx, chunk);
+    ASSERT_TRUE(cache.push(slab, class_idx));
+  }
+
+  std::vector<void*> released;
+  EXPECT_EQ(cache.release([&](void* chunk) { released.push_back(chunk); }), 3u);
+  EXPECT_EQ(cache.slab_count(), 0u);
+  EXPECT_EQ(std::set<void*>(released.begin(), released.end()),
+            std::set<void*>(chunks.begin(), chunks.end()));
+
+  for (void* chunk : chunks) {
+    HugepageProvider::deallocate_chunk(chunk);
+  }
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "nexusalloc/chunk_refiller.hpp"
+
+using namespace nexusalloc;
+
+namespace {
+
+// Poll until the global pool holds at least `depth` chunks or the timeout expires
+bool wait_for_pool_depth(size_t depth) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (global_page_stack().approximate_size() >= depth) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+}  // namespace
+
+class ChunkRefillerTest : public ::testing::Test {
+ protected:
+  // A test that fails before its own stop() must not leave the thread running for the next one
+  void TearDown() override { ChunkRefiller::stop(); }
+};
+
+TEST_F(ChunkRefillerTest, RejectsInvalidWatermarks) {
+  RefillOptions options;
+  options.low_watermark = 8;
+  options.high_watermark = 4;
+  EXPECT_FALSE(ChunkRefiller::start(options));
+
+  options.low_watermark = 0;
+  EXPECT_FALSE(ChunkRefiller::start(options));
+  EXPECT_FALSE(ChunkRefiller::running());
+}
+
+TEST_F(ChunkRefillerTest, TopsUpPoolToHighWatermark) {
+  RefillOptions options;
+  options.low_watermark = 2;
+  options.high_watermark = 4;
+  options.poll_interval = std::chrono::milliseconds(1);
+
+  ASSERT_TRUE(ChunkRefiller::start(options));
+  EXPECT_TRUE(ChunkRefiller::running());
+  EXPECT_TRUE(wait_for_pool_depth(4));
+
+  // Drain the pool below the low watermark; the refiller must restore it
+  std::vector<void*> taken;
+  while (void* chunk = global_page_stack().pop()) {
+    taken.push_back(chunk);
+  }
+  ChunkRefiller::notify_low(0);
+  EXPECT_TRUE(wait_for_pool_depth(4));
+
+  ChunkRefiller::stop();
+  EXPECT_FALSE(ChunkRefiller::running());
+
+  for (void* chunk : taken) {
+    global_page_stack().push(chunk);
+  }
+}
+
+TEST_F(ChunkRefillerTest, StartIsIdempotent) {
+  ASSERT_TRUE(ChunkRefiller::start());
+  EXPECT_TRUE(ChunkRefiller::start());
+  ChunkRefiller::stop();
+  ChunkRefiller::stop();
+  EXPECT_FALSE(ChunkRefiller::running());
+}
+
+TEST_F(ChunkRefillerTest, DecayUnmapsIdleChunks) {
+  constexpr size_t kChunks = 4;
+  for (size_t i = 0; i < kChunks; ++i) {
+    global_page_stack().push(HugepageProvider::allocate_chunk());
+  }
+  // Earlier tests may have left chunks pooled; decay unmaps those too
+  const size_t pooled = global_page_stack().approximate_size();
+  ASSERT_GE(pooled, kChunks);
+  const size_t mapped = HugepageProvider::stats().chunks_mapped;
+
+  // Zero watermarks run the thread for decay only
+  RefillOptions options;
+  options.low_watermark = 0;
+  options.high_watermark = 0;
+  options.poll_interval = std::chrono::milliseconds(1);
+  options.decay = std::chrono::milliseconds(20);
+  ASSERT_TRUE(ChunkRefiller::start(options));
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (global_page_stack().approximate_size() > 0 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ChunkRefiller::stop();
+
+  EXPECT_EQ(global_page_stack().approximate_size(), 0u);
+  EXPECT_EQ(HugepageProvider::stats().chunks_mapped, mapped - pooled);
+}
+
+TEST_F(ChunkRefillerTest, DecayWhileOtherThreadsPop) {
+  RefillOptions options;
+  options.low_watermark = 0;
+  options.high_watermark = 0;
+  options.poll_interval = std::chrono::milliseconds(1);
+  options.decay = std::chrono::milliseconds(1);
+  ASSERT_TRUE(ChunkRefiller::start(options));
+
+  // The refill thread unmaps chunks these threads may be about to read the link of
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> poppers;
+  for (int t = 0; t < 3; ++t) {
+    poppers.emplace_back([&] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (void* chunk = global_page_stack().pop()) global_page_stack().push(chunk);
+      }
+    });
+  }
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+  while (std::chrono::steady_clock::now() < deadline) {
+    for (int i = 0; i < 16; ++i) global_page_stack().push(HugepageProvider::allocate_chunk());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& t : poppers) t.join();
+  ChunkRefiller::stop();
+  HugepageProvider::purge();
+}
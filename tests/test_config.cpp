@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "nexusalloc/config.hpp"
+
+using namespace nexusalloc;
+
+TEST(ConfigTest, NullOrEmptyKeepsDefaults) {
+  const Config defaults;
+  for (const char* conf : {static_cast<const char*>(nullptr), "", ",,"}) {
+    Config config = parse_config(conf);
+    EXPECT_EQ(config.page_mode, defaults.page_mode);
+    EXPECT_EQ(config.populate, PopulatePolicy::kEager);
+    EXPECT_EQ(config.decay_ms, -1);
+    EXPECT_EQ(config.large_cache_bytes, 0u);
+    EXPECT_EQ(config.thread_cache_slabs, 1u);
+    EXPECT_EQ(config.thread_cache_bytes, Config::kUnlimited);
+    EXPECT_EQ(config.arena_pool, 16u);
+    EXPECT_EQ(config.soft_limit, Config::kFromCgroup);
+    EXPECT_EQ(config.hard_limit, Config::kFromCgroup);
+    EXPECT_FALSE(config.stats);
+    EXPECT_FALSE(config.track_large);
+    EXPECT_EQ(config.numa, NumaPolicy::kDefault);
+  }
+}
+
+TEST(ConfigTest, ParsesEveryOption) {
+  Config config = parse_config(
+      "page_mode:thp,populate:background,decay_ms:2500,large_cache:64M,thread_cache_slabs:2,"
+      "thread_cache_bytes:256M,arena_pool:0,soft_limit:3G,hard_limit:unlimited,stats:true,"
+      "track_large:true,numa:spread");
+  EXPECT_EQ(config.page_mode, PageMode::kTransparent);
+  EXPECT_EQ(config.populate, PopulatePolicy::kBackground);
+  EXPECT_EQ(config.decay_ms, 2500);
+  EXPECT_EQ(config.large_cache_bytes, size_t{64} << 20);
+  EXPECT_EQ(config.thread_cache_slabs, 2u);
+  EXPECT_EQ(config.thread_cache_bytes, size_t{256} << 20);
+  EXPECT_EQ(config.arena_pool, 0u);
+  EXPECT_EQ(config.soft_limit, size_t{3} << 30);
+  EXPECT_EQ(config.hard_limit, Config::kUnlimited);
+  EXPECT_TRUE(config.stats);
+  EXPECT_TRUE(config.track_large);
+  EXPECT_EQ(config.numa, NumaPolicy::kSpread);
+}
+
+TEST(ConfigTest, ParsesSizeSuffixes) {
+  EXPECT_EQ(parse_config("large_cache:4096").large_cache_bytes, 4096u);
+  EXPECT_EQ(parse_config("large_cache:8k").large_cache_bytes, 8192u);
+  EXPECT_EQ(parse_config("large_cache:1G").large_cache_bytes, size_t{1} << 30);
+}
+
+TEST(ConfigTest, SkipsInvalidPairsAndKeepsValidOnes) {
+  Config config = parse_config(
+      "bogus:1,page_mode:huge,decay_ms:-5,large_cache:12X,stats,populate:lazy,"
+      "thread_cache_slabs:unlimited,arena_pool:-1,hard_limit:lots,page_mode:regular");
+  EXPECT_EQ(config.page_mode, PageMode::kRegular);
+  EXPECT_EQ(config.populate, PopulatePolicy::kLazy);
+  EXPECT_EQ(config.decay_ms, -1);
+  EXPECT_EQ(config.large_cache_bytes, 0u);
+  EXPECT_EQ(config.thread_cache_slabs, Config::kUnlimited);
+  EXPECT_EQ(config.arena_pool, 16u);
+  EXPECT_EQ(config.hard_limit, Config::kFromCgroup);
+  EXPECT_FALSE(config.stats);
+}
@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "nexusalloc/allocator.hpp"
+#include "nexusalloc/heap.hpp"
+
+using namespace nexusalloc;
+
+TEST(HeapTest, HeapsDoNotShareSlabs) {
+  Heap a;
+  Heap b;
+  void* pa = a.allocate(64);
+  void* pb = b.allocate(64);
+  ASSERT_NE(pa, nullptr);
+  ASSERT_NE(pb, nullptr);
+  EXPECT_NE(internal::slab_base_from_ptr(pa), internal::slab_base_from_ptr(pb));
+  EXPECT_EQ(a.chunk_count(), 1u);
+  EXPECT_EQ(b.chunk_count(), 1u);
+
+  a.deallocate(pa, 64);
+  b.deallocate(pb, 64);
+}
+
+TEST(HeapTest, MappedBytesCountsChunksAndLargeAllocations) {
+  Heap heap;
+  EXPECT_EQ(heap.mapped_bytes(), 0u);
+
+  void* small = heap.allocate(128);
+  void* large = heap.allocate(1 << 20);
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(heap.mapped_bytes(), PageTraits::kChunkSize + (1 << 20));
+
+  heap.deallocate(large, 1 << 20);
+  EXPECT_EQ(heap.mapped_bytes(), PageTraits::kChunkSize);
+  heap.deallocate(small, 128);
+}
+
+TEST(HeapTest, DestroyFreesEverything) {
+  const size_t large_before = HugepageProvider::stats().large_allocations;
+
+  Heap heap;
+  for (size_t size : {16, 64, 256, 4096, 65536}) {
+    for (int i = 0; i < 100; ++i) {
+      void* ptr = heap.allocate(size);
+      ASSERT_NE(ptr, nullptr);
+      std::memset(ptr, 0x11, size);
+    }
+  }
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_NE(heap.allocate(1 << 20), nullptr);
+  }
+  const size_t chunks = heap.chunk_count();
+  EXPECT_GE(chunks, 5u);
+  EXPECT_EQ(HugepageProvider::stats().large_allocations, large_before + 3);
+
+  // Measured after the heap drew its chunks, which may have come from the pool
+  const size_t pooled_before = global_page_stack().approximate_size();
+  heap.destroy();
+  EXPECT_EQ(heap.chunk_count(), 0u);
+  EXPECT_EQ(heap.mapped_bytes(), 0u);
+  EXPECT_EQ(HugepageProvider::stats().large_allocations, large_before);
+  if (config().decay_ms != 0) {
+    EXPECT_EQ(global_page_stack().approximate_size(), pooled_before + chunks);
+  }
+
+  // Still usable afterwards
+  void* ptr = heap.allocate(64);
+  ASSERT_NE(ptr, nullptr);
+  heap.deallocate(ptr, 64);
+}
+
+TEST(HeapTest, LargeBlocksFreedBeforeDestroyAreNotFreedTwice) {
+  const size_t large_before = HugepageProvider::stats().large_allocations;
+  {
+    Heap heap;
+    void* ptr = heap.allocate(1 << 20);
+    ASSERT_NE(ptr, nullptr);
+    heap.deallocate(ptr, 1 << 20);
+  }
+  EXPECT_EQ(HugepageProvider::stats().large_allocations, large_before);
+}
+
+TEST(HeapTest, OverBudgetEmptySlabsGoToCentralCache) {
+  if (config().decay_ms == 0) GTEST_SKIP() << "decay_ms:0 returns chunks instead";
+  central_cache().release(&Heap::return_chunk);
+
+  // Four slabs' worth of 64KB blocks against a one-slab budget
+  constexpr size_t kSize = 65536;
+  constexpr size_t kBlocksPerSlab = PageTraits::kChunkSize / kSize;
+  Heap donor;
+  donor.set_byte_budget(PageTraits::kChunkSize);
+  std::vector<void*> ptrs;
+  for (size_t i = 0; i < 4 * kBlocksPerSlab; ++i) {
+    void* ptr = donor.allocate(kSize);
+    ASSERT_NE(ptr, nullptr);
+    ptrs.push_back(ptr);
+  }
+  ASSERT_EQ(donor.chunk_count(), 4u);
+
+  // The current slab stays; each full slab that empties leaves while the heap is over budget
+  for (void* ptr : ptrs) {
+    donor.deallocate(ptr, kSize);
+  }
+  EXPECT_EQ(donor.chunk_count(), 1u);
+  EXPECT_EQ(central_cache().slab_count(), 3u);
+
+  // Another heap draws those slabs before taking chunks from the pool
+  const size_t pooled_before = global_page_stack().approximate_size();
+  Heap taker;
+  void* ptr = taker.allocate(kSize);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(std::count_if(ptrs.begin(), ptrs.end(), [&](void* p) {
+    return internal::slab_base_from_ptr(p) == internal::slab_base_from_ptr(ptr);
+  }) > 0);
+  EXPECT_EQ(central_cache().slab_count(), 2u);
+  EXPECT_EQ(global_page_stack().approximate_size(), pooled_before);
+  taker.deallocate(ptr, kSize);
+
+  // Other size classes never see them
+  void* small = taker.allocate(64);
+  EXPECT_EQ(central_cache().slab_count(), 2u);
+  taker.deallocate(small, 64);
+
+  EXPECT_EQ(central_cache().release(&Heap::return_chunk), 2u);
+  EXPECT_EQ(central_cache().slab_count(), 0u);
+}
+
+TEST(HeapTest, WithinBudgetEmptySlabsStay) {
+  central_cache().release(&Heap::return_chunk);
+  Heap heap;
+  heap.set_byte_budget(size_t{64} << 20);
+  EXPECT_EQ(heap.byte_budget(), size_t{64} << 20);
+
+  constexpr size_t kSize = 65536;
+  std::vector<void*> ptrs;
+  for (size_t i = 0; i < 2 * PageTraits::kChunkSize / kSize; ++i) {
+    ptrs.push_back(heap.allocate(kSize));
+  }
+  for (void* ptr : ptrs) {
+    heap.deallocate(ptr, kSize);
+  }
+  EXPECT_EQ(heap.chunk_count(), 2u);
+  EXPECT_EQ(central_cache().slab_count(), 0u);
+}
+
+TEST(HeapTest, RefillsFromFullestPartialSlab) {
+  for (SlabSelection selection : {SlabSelection::kFullest, SlabSelection::kNewest}) {
+    Heap heap;
+    heap.set_empty_slab_limit(0);
+    heap.set_slab_selection(selection);
+    EXPECT_EQ(heap.slab_selection(), selection);
+
+    // Three full slabs in allocation order: the sparse one, freed into last, the dense one and
+    // the current one
+    constexpr size_t kSize = 65536;
+    constexpr size_t kPerSlab = PageTraits::kChunkSize / kSize;
+    std::vector<void*> ptrs;
+    while (heap.chunk_count() < 3 || ptrs.size() % kPerSlab != 0) {
+      ptrs.push_back(heap.allocate(kSize));
+    }
+    ASSERT_EQ(ptrs.size(), 3 * kPerSlab);
+    const auto chunk_of = [](void* ptr) {
+      return reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t{PageTraits::kChunkSize} - 1);
+    };
+    void* dense_slab_ptr = ptrs[kPerSlab];
+    heap.deallocate(dense_slab_ptr, kSize);
+    for (size_t i = 1; i < kPerSlab; ++i) {
+      heap.deallocate(ptrs[i], kSize);
+    }
+
+    void* ptr = heap.allocate(kSize);
+    if (selection == SlabSelection::kFullest) {
+      EXPECT_EQ(chunk_of(ptr), chunk_of(dense_slab_ptr));
+      // The sparse slab was left alone, so it drains and goes back
+      heap.deallocate(ptrs[0], kSize);
+      EXPECT_EQ(heap.chunk_count(), 2u);
+    } else {
+      EXPECT_EQ(chunk_of(ptr), chunk_of(ptrs[0]));
+    }
+    heap.deallocate(ptr, kSize);
+  }
+}
+
+TEST(HeapTest, IsolatedBlocksOwnTheirCacheLines) {
+  Heap heap;
+  constexpr size_t kLine = internal::kCacheLineSize;
+  std::set<uintptr_t> lines;
+  std::vector<std::pair<void*, size_t>> blocks;
+  for (size_t size : {0, 1, 8, 16, 24, 48, 64, 65, 100, 200, 300, 5000}) {
+    for (size_t i = 0; i < 8; ++i) {
+      void* ptr = heap.allocate(size, flags::isolated);
+      ASSERT_NE(ptr, nullptr);
+      EXPECT_TRUE(internal::is_aligned(ptr, kLine)) << size;
+      const uintptr_t first = reinterpret_cast<uintptr_t>(ptr) / kLine;
+      for (uintptr_t line = first; line < first + std::max<size_t>((size + kLine - 1) / kLine, 1);
+           ++line) {
+        EXPECT_TRUE(lines.insert(line).second) << size;
+      }
+      blocks.emplace_back(ptr, size);
+    }
+  }
+  for (auto [ptr, size] : blocks) {
+    heap.deallocate(ptr, size, flags::isolated);
+  }
+  EXPECT_EQ(heap.mapped_bytes(), heap.chunk_count() * PageTraits::kChunkSize);
+}
+
+TEST(HeapTest, AllocateFailsAtHardLimit) {
+  HugepageProvider::purge();
+  HugepageProvider::set_memory_limits(Config::kUnlimited, HugepageProvider::stats().mapped_bytes());
+
+  Heap heap;
+  EXPECT_EQ(heap.allocate(64), nullptr);
+  EXPECT_EQ(heap.allocate(1 << 20), nullptr);
+  EXPECT_EQ(heap.chunk_count(), 0u);
+
+  HugepageProvider::set_memory_limits(Config::kFromCgroup, Config::kFromCgroup);
+  void* ptr = heap.allocate(64);
+  EXPECT_NE(ptr, nullptr);
+  heap.deallocate(ptr, 64);
+}
+
+TEST(HeapTest, ForEachLiveBlockVisitsSlabsAndLargeBlocks) {
+  Heap heap;
+  std::map<void*, size_t> live;
+  // Enough 4KB blocks to fill a slab, so full slabs are walked too
+  for (size_t i = 0; i < PageTraits::kChunkSize / 4096 + 10; ++i) live[heap.allocate(4000)] = 4096;
+  for (size_t i = 0; i < 100; ++i) live[heap.allocate(24)] = 32;
+  live[heap.allocate(200000)] = internal::align_up(size_t{200000}, PageTraits::kRegularPageSize);
+
+  // Free some so partial slabs and free lists are involved
+  for (auto it = live.begin(); it != live.end();) {
+    if (it->second != 32 || reinterpret_cast<uintptr_t>(it->first) % 3 != 0) {
+      ++it;
+      continue;
+    }
+    heap.deallocate(it->first, it->second);
+    it = live.erase(it);
+  }
+  ASSERT_EQ(live.count(nullptr), 0u);
+
+  std::map<void*, size_t> walked;
+  heap.for_each_live_block([&](void* ptr, size_t size) { walked[ptr] = size; });
+  EXPECT_EQ(walked, live);
+
+  for (const auto& [ptr, size] : live) heap.deallocate(ptr, size);
+  size_t remaining = 0;
+  heap.for_each_live_block([&](void*, size_t) { ++remaining; });
+  EXPECT_EQ(remaining, 0u);
+}
+
+TEST(HeapAllocatorTest, ContainersAllocateFromTheirHeap) {
+  Heap heap;
+  {
+    using Alloc = NexusAllocator<std::pair<const int, std::string>, Heap*>;
+    std::map<int, std::string, std::less<int>, Alloc> map{Alloc(&heap)};
+    std::vector<int, NexusAllocator<int, Heap*>> vec{NexusAllocator<int, Heap*>(&heap)};
+    for (int i = 0; i < 1000; ++i) {
+      map.emplace(i, std::to_string(i));
+      vec.push_back(i);
+    }
+    EXPECT_EQ(map.at(500), "500");
+    EXPECT_GE(heap.chunk_count(), 2u);
+
+    // Rebound copies stay bound to the same heap
+    NexusAllocator<double, Heap*> rebound(vec.get_allocator());
+    EXPECT_EQ(rebound.heap(), &heap);
+    EXPECT_TRUE(rebound == vec.get_allocator());
+
+    Heap other;
+    EXPECT_FALSE((NexusAllocator<int, Heap*>(&other) == vec.get_allocator()));
+  }
+}
@@ -0,0 +1,448 @@
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nexusalloc/hugepage_provider.hpp"
+#include "nexusalloc/internal/cgroup.hpp"
+#include "nexusalloc/internal/numa.hpp"
+
+using namespace nexusalloc;
+
+TEST(HugepageProviderTest, StatsTrackChunks) {
+  const size_t before = HugepageProvider::stats().chunks_mapped;
+
+  void* chunk = HugepageProvider::allocate_chunk();
+  ASSERT_NE(chunk, nullptr);
+  EXPECT_EQ(HugepageProvider::stats().chunks_mapped, before + 1);
+
+  HugepageProvider::deallocate_chunk(chunk);
+  EXPECT_EQ(HugepageProvider::stats().chunks_mapped, before);
+}
+
+TEST(HugepageProviderTest, StatsTrackLargeAllocations) {
+  const ProviderStats before = HugepageProvider::stats();
+  constexpr size_t kSize = 256 * 1024;
+
+  void* ptr = HugepageProvider::allocate_large(kSize);
+  ASSERT_NE(ptr, nullptr);
+
+  ProviderStats during = HugepageProvider::stats();
+  EXPECT_EQ(during.large_allocations, before.large_allocations + 1);
+  EXPECT_EQ(during.large_bytes, before.large_bytes + kSize);
+  EXPECT_EQ(during.mapped_bytes(), before.mapped_bytes() + kSize);
+
+  HugepageProvider::deallocate_large(ptr, kSize);
+  EXPECT_EQ(HugepageProvider::stats().large_bytes, before.large_bytes);
+}
+
+TEST(HugepageProviderTest, StatsMoveByExpectedAmounts) {
+  HugepageProvider::set_large_cache_limit(0);
+  constexpr size_t kLarge = 512 * 1024;
+  const ProviderStats before = HugepageProvider::stats();
+
+  void* chunk = HugepageProvider::allocate_chunk();
+  ASSERT_NE(chunk, nullptr);
+  const PageMode backing = HugepageProvider::chunk_backing(chunk);
+  void* large = HugepageProvider::allocate_large(kLarge);
+  ASSERT_NE(large, nullptr);
+
+  ProviderStats during = HugepageProvider::stats();
+  EXPECT_EQ(during.chunks_mapped, before.chunks_mapped + 1);
+  EXPECT_EQ(during.chunks_backed_by(backing), before.chunks_backed_by(backing) + 1);
+  EXPECT_EQ(during.large_allocations, before.large_allocations + 1);
+  EXPECT_EQ(during.large_bytes, before.large_bytes + kLarge);
+  EXPECT_EQ(during.large_cached_bytes, before.large_cached_bytes);
+  EXPECT_EQ(during.mapped_bytes(), before.mapped_bytes() + PageTraits::kChunkSize + kLarge);
+
+  // A pooled chunk stays mapped; a cached large mapping moves from live to cached bytes
+  const size_t pooled = global_page_stack().approximate_size();
+  global_page_stack().push(chunk);
+  EXPECT_EQ(global_page_stack().approximate_size(), pooled + 1);
+  HugepageProvider::set_large_cache_limit(kLarge);
+  HugepageProvider::deallocate_large(large, kLarge);
+
+  during = HugepageProvider::stats();
+  EXPECT_EQ(during.chunks_mapped, before.chunks_mapped + 1);
+  EXPECT_EQ(during.large_allocations, before.large_allocations);
+  EXPECT_EQ(during.large_bytes, before.large_bytes);
+  EXPECT_EQ(during.large_cached_bytes, before.large_cached_bytes + kLarge);
+  EXPECT_EQ(during.mapped_bytes(), before.mapped_bytes() + PageTraits::kChunkSize + kLarge);
+
+  // purge() unmaps the pool, our chunk included, and the cache
+  HugepageProvider::purge();
+  const ProviderStats after = HugepageProvider::stats();
+  EXPECT_EQ(global_page_stack().approximate_size(), 0u);
+  EXPECT_LE(after.chunks_mapped, during.chunks_mapped - (pooled + 1));
+  EXPECT_EQ(after.large_cached_bytes, 0u);
+  EXPECT_EQ(after.mapped_bytes(), after.chunks_mapped * PageTraits::kChunkSize + after.large_bytes);
+  HugepageProvider::set_large_cache_limit(0);
+}
+
+TEST(HugepageProviderTest, AllocateChunkOnNode) {
+  EXPECT_GE(internal::numa_node_count(), 1);
+
+  void* chunk = HugepageProvider::allocate_chunk_on_node(0);
+  ASSERT_NE(chunk, nullptr);
+
+  // Chunk is already faulted in and must be usable end to end
+  std::memset(chunk, 0xAB, HugepageProvider::chunk_size());
+  EXPECT_EQ(static_cast<unsigned char*>(chunk)[HugepageProvider::chunk_size() - 1], 0xAB);
+
+  HugepageProvider::deallocate_chunk(chunk);
+}
+
+TEST(HugepageProviderTest, PageModeRoundTrip) {
+  const PageMode original = HugepageProvider::page_mode();
+
+  HugepageProvider::set_page_mode(PageMode::kRegular);
+  EXPECT_EQ(HugepageProvider::page_mode(), PageMode::kRegular);
+
+  HugepageProvider::set_page_mode(original);
+  EXPECT_EQ(HugepageProvider::page_mode(), original);
+}
+
+TEST(HugepageProviderTest, GiganticModeFallsBackOrCarves) {
+  const PageMode original = HugepageProvider::page_mode();
+  HugepageProvider::set_page_mode(PageMode::kHugetlb1G);
+
+  // With or without 1GB pages configured, every request must yield a usable, distinct chunk
+  constexpr int kChunks = 4;
+  void* chunks[kChunks];
+  for (auto& chunk : chunks) {
+    chunk = HugepageProvider::allocate_chunk();
+    ASSERT_NE(chunk, nullptr);
+    std::memset(chunk, 0x5A, 4096);
+  }
+  for (int i = 1; i < kChunks; ++i) {
+    EXPECT_NE(chunks[i], chunks[i - 1]);
+  }
+
+  if (HugepageProvider::stats().gigantic_regions > 0) {
+    // Chunks carved from the same region are contiguous 2MB slices
+    EXPECT_EQ(static_cast<char*>(chunks[1]) - static_cast<char*>(chunks[0]),
+              static_cast<ptrdiff_t>(PageTraits::kChunkSize));
+  }
+
+  const size_t mapped_before_free = HugepageProvider::stats().chunks_mapped;
+  for (void* chunk : chunks) {
+    HugepageProvider::deallocate_chunk(chunk);
+  }
+  EXPECT_LE(HugepageProvider::stats().chunks_mapped, mapped_before_free);
+
+  HugepageProvider::set_page_mode(original);
+}
+
+TEST(HugepageProviderTest, FallbackChunksAreChunkAligned) {
+  const PageMode original = HugepageProvider::page_mode();
+
+  for (PageMode mode : {PageMode::kRegular, PageMode::kTransparent}) {
+    HugepageProvider::set_page_mode(mode);
+    void* chunk = HugepageProvider::allocate_chunk();
+    ASSERT_NE(chunk, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(chunk) % PageTraits::kChunkSize, 0u);
+
+    std::memset(chunk, 0x3C, PageTraits::kChunkSize);
+    HugepageProvider::deallocate_chunk(chunk);
+  }
+
+  HugepageProvider::set_page_mode(original);
+}
+
+TEST(HugepageProviderTest, TransparentModeReportsBacking) {
+  const PageMode original = HugepageProvider::page_mode();
+  HugepageProvider::set_page_mode(PageMode::kTransparent);
+  HugepageProvider::set_thp_collapse(true);
+
+  void* chunk = HugepageProvider::allocate_chunk();
+  ASSERT_NE(chunk, nullptr);
+
+  // Whether THP actually backs the chunk depends on the host; the report must stay in range
+  EXPECT_LE(HugepageProvider::thp_backed_bytes(chunk, PageTraits::kChunkSize),
+            PageTraits::kChunkSize);
+
+  HugepageProvider::deallocate_chunk(chunk);
+  HugepageProvider::set_thp_collapse(false);
+  HugepageProvider::set_page_mode(original);
+}
+
+TEST(HugepageProviderTest, StatsReportChunkBacking) {
+  const PageMode original = HugepageProvider::page_mode();
+  HugepageProvider::set_page_mode(PageMode::kRegular);
+  const size_t before = HugepageProvider::stats().chunks_backed_by(PageMode::kRegular);
+
+  void* chunk = HugepageProvider::allocate_chunk();
+  ASSERT_NE(chunk, nullptr);
+  EXPECT_EQ(HugepageProvider::chunk_backing(chunk), PageMode::kRegular);
+  EXPECT_EQ(HugepageProvider::stats().chunks_backed_by(PageMode::kRegular), before + 1);
+
+  HugepageProvider::deallocate_chunk(chunk);
+  EXPECT_EQ(HugepageProvider::stats().chunks_backed_by(PageMode::kRegular), before);
+
+  HugepageProvider::set_page_mode(original);
+}
+
+TEST(HugepageProviderTest, ProbeSkipsExhaustedHugetlbPool) {
+  HugepageProvider::probe();
+  if (internal::hugetlb_availability(2048) != internal::Availability::kUnavailable) {
+    GTEST_SKIP() << "2MB hugetlb pages are available or sysfs is unreadable";
+  }
+  EXPECT_FALSE(HugepageProvider::strategy_available(PageMode::kHugetlb2M));
+
+  const PageMode original = HugepageProvider::page_mode();
+  HugepageProvider::set_page_mode(PageMode::kHugetlb2M);
+  const size_t failures = HugepageProvider::stats().hugetlb_failures;
+
+  // Falls straight through to the next strategy without a doomed MAP_HUGETLB attempt
+  void* chunk = HugepageProvider::allocate_chunk();
+  ASSERT_NE(chunk, nullptr);
+  EXPECT_NE(HugepageProvider::chunk_backing(chunk), PageMode::kHugetlb2M);
+  EXPECT_EQ(HugepageProvider::stats().hugetlb_failures, failures);
+
+  HugepageProvider::deallocate_chunk(chunk);
+  HugepageProvider::set_page_mode(original);
+}
+
+TEST(HugepageProviderTest, PopulatePolicyControlsFaulting) {
+  const PageMode original_mode = HugepageProvider::page_mode();
+  const PopulatePolicy original_policy = HugepageProvider::populate_policy();
+  HugepageProvider::set_page_mode(PageMode::kRegular);
+
+  constexpr size_t kPages = PageTraits::kChunkSize / PageTraits::kRegularPageSize;
+  auto resident_pages = [](void* chunk) {
+    unsigned char residency[kPages];
+    EXPECT_EQ(mincore(chunk, PageTraits::kChunkSize, residency), 0);
+    size_t resident = 0;
+    for (unsigned char page : residency) resident += page & 1;
+    return resident;
+  };
+
+  HugepageProvider::set_populate_policy(PopulatePolicy::kEager);
+  void* eager = HugepageProvider::allocate_chunk();
+  ASSERT_NE(eager, nullptr);
+  EXPECT_EQ(resident_pages(eager), kPages);
+
+  HugepageProvider::set_populate_policy(PopulatePolicy::kLazy);
+  EXPECT_EQ(HugepageProvider::populate_policy(), PopulatePolicy::kLazy);
+  void* lazy = HugepageProvider::allocate_chunk();
+  ASSERT_NE(lazy, nullptr);
+  EXPECT_EQ(resident_pages(lazy), 0u);
+
+  // Reservation and the refill thread always get faulted chunks
+  void* populated = HugepageProvider::allocate_populated_chunk();
+  ASSERT_NE(populated, nullptr);
+  EXPECT_EQ(resident_pages(populated), kPages);
+
+  for (void* chunk : {eager, lazy, populated}) {
+    HugepageProvider::deallocate_chunk(chunk);
+  }
+  HugepageProvider::set_populate_policy(original_policy);
+  HugepageProvider::set_page_mode(original_mode);
+}
+
+TEST(HugepageProviderTest, LargeCacheReusesExactSizes) {
+  constexpr size_t kSize = 256 * 1024;
+  HugepageProvider::set_large_cache_limit(4 * kSize);
+
+  void* first = HugepageProvider::allocate_large(kSize);
+  ASSERT_NE(first, nullptr);
+  HugepageProvider::deallocate_large(first, kSize);
+  EXPECT_EQ(HugepageProvider::stats().large_cached_bytes, kSize);
+
+  // A different size cannot reuse the cached mapping
+  void* other = HugepageProvider::allocate_large(2 * kSize);
+  ASSERT_NE(other, nullptr);
+  EXPECT_NE(other, first);
+  HugepageProvider::deallocate_large(other, 2 * kSize);
+
+  void* second = HugepageProvider::allocate_large(kSize);
+  EXPECT_EQ(second, first);
+  HugepageProvider::deallocate_large(second, kSize);
+
+  // Over the limit, freed mappings are unmapped as before
+  void* too_big = HugepageProvider::allocate_large(8 * kSize);
+  ASSERT_NE(too_big, nullptr);
+  HugepageProvider::deallocate_large(too_big, 8 * kSize);
+  EXPECT_EQ(HugepageProvider::stats().large_cached_bytes, 3 * kSize);
+
+  HugepageProvider::set_large_cache_limit(0);
+  EXPECT_EQ(HugepageProvider::stats().large_cached_bytes, 0u);
+  EXPECT_EQ(HugepageProvider::stats().large_allocations, 0u);
+
+  // Unlimited is a limit of its own, not a fallback to NEXUSALLOC_CONF
+  HugepageProvider::set_large_cache_limit(Config::kUnlimited);
+  EXPECT_EQ(HugepageProvider::large_cache_limit(), Config::kUnlimited);
+  HugepageProvider::set_large_cache_limit(0);
+}
+
+TEST(HugepageProviderTest, HardLimitRefusesMappings) {
+  HugepageProvider::purge();
+  const ProviderStats before = HugepageProvider::stats();
+  HugepageProvider::set_memory_limits(Config::kUnlimited,
+                                      before.mapped_bytes() + 2 * PageTraits::kChunkSize);
+
+  void* a = HugepageProvider::allocate_chunk();
+  void* b = HugepageProvider::allocate_chunk();
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(HugepageProvider::allocate_chunk(), nullptr);
+  EXPECT_EQ(HugepageProvider::allocate_large(PageTraits::kRegularPageSize), nullptr);
+
+  const ProviderStats after = HugepageProvider::stats();
+  EXPECT_EQ(after.chunks_mapped, before.chunks_mapped + 2);
+  EXPECT_EQ(after.limit_failures, before.limit_failures + 2);
+
+  // Freeing makes room again
+  HugepageProvider::deallocate_chunk(b);
+  void* c = HugepageProvider::allocate_chunk();
+  EXPECT_NE(c, nullptr);
+
+  HugepageProvider::set_memory_limits(Config::kFromCgroup, Config::kFromCgroup);
+  HugepageProvider::deallocate_chunk(a);
+  HugepageProvider::deallocate_chunk(c);
+}
+
+TEST(HugepageProviderTest, SoftLimitPurgesPoolAndNotifiesOnce) {
+  HugepageProvider::purge();
+  for (int i = 0; i < 2; ++i) {
+    void* chunk = HugepageProvider::allocate_chunk();
+    ASSERT_NE(chunk, nullptr);
+    global_page_stack().push(chunk);
+  }
+  const ProviderStats before = HugepageProvider::stats();
+  HugepageProvider::set_memory_limits(before.mapped_bytes() + PageTraits::kChunkSize / 2,
+                                      Config::kUnlimited);
+
+  struct Seen {
+    size_t calls{0};
+    size_t mapped{0};
+  } seen;
+  HugepageProvider::set_pressure_callback(
+      [](size_t mapped, void* context) {
+        auto* s = static_cast<Seen*>(context);
+        ++s->calls;
+        s->mapped = mapped;
+      },
+      &seen);
+
+  // Crossing the soft limit unmaps the two pooled chunks before the callback runs
+  void* chunk = HugepageProvider::allocate_chunk();
+  ASSERT_NE(chunk, nullptr);
+  EXPECT_EQ(seen.calls, 1u);
+  EXPECT_EQ(seen.mapped, before.mapped_bytes() - PageTraits::kChunkSize);
+  EXPECT_EQ(global_page_stack().approximate_size(), 0u);
+  EXPECT_EQ(HugepageProvider::stats().pressure_events, before.pressure_events + 1);
+
+  // Back under the limit, so the next crossing notifies again
+  void* again = HugepageProvider::allocate_chunk();
+  ASSERT_NE(again, nullptr);
+  EXPECT_FALSE(HugepageProvider::under_pressure());
+  EXPECT_EQ(seen.calls, 1u);
+
+  HugepageProvider::set_pressure_callback(nullptr);
+  HugepageProvider::set_memory_limits(Config::kFromCgroup, Config::kFromCgroup);
+  HugepageProvider::deallocate_chunk(chunk);
+  HugepageProvider::deallocate_chunk(again);
+}
+
+TEST(HugepageProviderTest, RefillChunksStopAtSoftLimit) {
+  HugepageProvider::purge();
+  const ProviderStats before = HugepageProvider::stats();
+  HugepageProvider::set_memory_limits(before.mapped_bytes() + PageTraits::kChunkSize * 3 / 2,
+                                      Config::kUnlimited);
+  size_t calls = 0;
+  HugepageProvider::set_pressure_callback(
+      [](size_t, void* context) { ++*static_cast<size_t*>(context); }, &calls);
+
+  // One chunk fits under the limit, the next would cross it: refused, with no purge or callback
+  void* chunk = HugepageProvider::allocate_refill_chunk();
+  ASSERT_NE(chunk, nullptr);
+  EXPECT_EQ(HugepageProvider::allocate_refill_chunk(), nullptr);
+  EXPECT_EQ(calls, 0u);
+  EXPECT_FALSE(HugepageProvider::under_pressure());
+  EXPECT_EQ(HugepageProvider::stats().pressure_events, before.pressure_events);
+
+  HugepageProvider::set_pressure_callback(nullptr);
+  HugepageProvider::set_memory_limits(Config::kFromCgroup, Config::kFromCgroup);
+  HugepageProvider::deallocate_chunk(chunk);
+}
+
+TEST(HugepageProviderTest, PurgeWhileOtherThreadsPop) {
+  // Poppers may still be reading a chunk's link when purge() takes it; the unmap has to wait
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> poppers;
+  for (int t = 0; t < 3; ++t) {
+    poppers.emplace_back([&] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (void* chunk = global_page_stack().pop()) global_page_stack().push(chunk);
+      }
+    });
+  }
+
+  for (int round = 0; round < 200; ++round) {
+    for (int i = 0; i < 4; ++i) {
+      void* chunk = HugepageProvider::allocate_chunk();
+      ASSERT_NE(chunk, nullptr);
+      global_page_stack().push(chunk);
+    }
+    HugepageProvider::purge();
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& t : poppers) t.join();
+  HugepageProvider::purge();
+  EXPECT_EQ(global_page_stack().approximate_size(), 0u);
+}
+
+TEST(CgroupTest, ReadsLimitsOfOwnGroup) {
+  char root[] = "/tmp/nexusalloc_cgroup_XXXXXX";
+  ASSERT_NE(mkdtemp(root), nullptr);
+  const std::string base(root);
+  auto write = [](const std::string& path, const char* text) {
+    FILE* f = std::fopen(path.c_str(), "w");
+    ASSERT_NE(f, nullptr);
+    std::fputs(text, f);
+    std::fclose(f);
+  };
+
+  write(base + "/self", "0::/\n");
+  write(base + "/memory.max", "1073741824\n");
+  write(base + "/memory.high", "max\n");
+  internal::CgroupMemoryLimits limits =
+      internal::cgroup_memory_limits(root, (base + "/self").c_str());
+  EXPECT_EQ(limits.max, size_t{1} << 30);
+  EXPECT_EQ(limits.high, internal::CgroupMemoryLimits::kUnlimited);
+
+  // A nested group wins over the root; without the directory the root is used
+  ASSERT_EQ(mkdir((base + "/app").c_str(), 0700), 0);
+  write(base + "/app/memory.max", "max\n");
+  write(base + "/app/memory.high", "536870912\n");
+  write(base + "/self", "12:memory:/ignored\n0::/app\n");
+  limits = internal::cgroup_memory_limits(root, (base + "/self").c_str());
+  EXPECT_EQ(limits.max, internal::CgroupMemoryLimits::kUnlimited);
+  EXPECT_EQ(limits.high, size_t{512} << 20);
+
+  write(base + "/self", "0::/missing\n");
+  limits = internal::cgroup_memory_limits(root, (base + "/self").c_str());
+  EXPECT_EQ(limits.max, size_t{1} << 30);
+
+  // No cgroup v2 hierarchy at all
+  limits = internal::cgroup_memory_limits((base + "/none").c_str(), (base + "/self").c_str());
+  EXPECT_EQ(limits.max, internal::CgroupMemoryLimits::kUnlimited);
+  EXPECT_EQ(limits.high, internal::CgroupMemoryLimits::kUnlimited);
+
+  for (const char* file : {"/app/memory.max", "/app/memory.high", "/self", "/memory.max",
+                           "/memory.high"}) {
+    std::remove((base + file).c_str());
+  }
+  rmdir((base + "/app").c_str());
+  rmdir(root);
+}
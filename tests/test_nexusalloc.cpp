@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <thread>
+
+#include "nexusalloc/nexusalloc.hpp"
+
+using namespace nexusalloc;
+
+TEST(NexusAllocTest, ReserveFillsGlobalPool) {
+  const size_t pooled_before = stats().chunks_pooled;
+
+  size_t reserved = reserve(3 * PageTraits::kChunkSize + 1);
+  EXPECT_EQ(reserved, 4);
+  EXPECT_EQ(stats().chunks_pooled, pooled_before + 4);
+}
+
+TEST(NexusAllocTest, ReserveNumaSpread) {
+  const size_t pooled_before = stats().chunks_pooled;
+
+  size_t reserved = reserve(2 * PageTraits::kChunkSize, /*numa_spread=*/true);
+  EXPECT_EQ(reserved, 2);
+  EXPECT_EQ(stats().chunks_pooled, pooled_before + 2);
+}
+
+TEST(NexusAllocTest, InitializeWithReservation) {
+  const size_t pooled_before = stats().chunks_pooled;
+
+  InitOptions options;
+  options.lock_memory = false;
+  options.reserve_bytes = 2 * PageTraits::kChunkSize;
+  initialize(options);
+
+  EXPECT_EQ(stats().chunks_pooled, pooled_before + 2);
+  EXPECT_FALSE(HugepageProvider::is_memory_locked());
+}
+
+TEST(NexusAllocTest, StatsReflectMappedMemory) {
+  Stats snapshot = stats();
+  EXPECT_GE(snapshot.provider.chunks_mapped, snapshot.chunks_pooled);
+  EXPECT_EQ(snapshot.mapped_bytes(), snapshot.provider.mapped_bytes());
+}
+
+TEST(NexusAllocTest, ForEachLiveBlockCoversEveryArena) {
+  ThreadArena::set_pool_limit(4);
+  ThreadArena::release_parked();  // Arenas parked by earlier tests would be adopted below
+  Heap::set_track_shared_large(true);
+  void* mine = allocate(1000);
+  void* large = allocate(300000);
+  ASSERT_NE(mine, nullptr);
+  ASSERT_NE(large, nullptr);
+
+  // A block left behind by an exited thread lives on in its parked arena
+  void* orphan = nullptr;
+  std::thread([&] { orphan = allocate(100); }).join();
+  ASSERT_NE(orphan, nullptr);
+  EXPECT_EQ(ThreadArena::parked_count(), 1u);
+
+  // And one held by a thread that is still running, but idle during the walk
+  std::atomic<void*> held{nullptr};
+  std::atomic<bool> walked_all{false};
+  std::thread holder([&] {
+    void* ptr = allocate(40);
+    held.store(ptr);
+    while (!walked_all.load()) std::this_thread::yield();
+    deallocate(ptr, 40);
+  });
+  while (held.load() == nullptr) std::this_thread::yield();
+
+  std::map<void*, size_t> walked;
+  for_each_live_block([&](void* ptr, size_t size) { walked[ptr] = size; });
+  walked_all.store(true);
+  holder.join();
+  EXPECT_EQ(walked[mine], 1024u);
+  EXPECT_EQ(walked[large], internal::align_up(size_t{300000}, PageTraits::kRegularPageSize));
+  EXPECT_EQ(walked[orphan], 112u);
+  EXPECT_EQ(walked[held.load()], 48u);
+
+  deallocate(large, 300000);
+  ThreadArena::release_parked();
+  walked.clear();
+  for_each_live_block([&](void* ptr, size_t size) { walked[ptr] = size; });
+  EXPECT_EQ(walked.count(mine), 1u);
+  EXPECT_EQ(walked.count(large), 0u);
+  EXPECT_EQ(walked.count(orphan), 0u);
+  EXPECT_EQ(walked.count(held.load()), 0u);
+
+  deallocate(mine, 1000);
+  ThreadArena::reset_pool_limit();
+  Heap::set_track_shared_large(config().track_large);
+}
+
+TEST(NexusAllocTest, ArenaLargeBlocksAreUntrackedByDefault) {
+  if (config().track_large) GTEST_SKIP() << "NEXUSALLOC_CONF has track_large:true";
+  void* large = allocate(300000);
+  ASSERT_NE(large, nullptr);
+
+  // Without tracking, large allocations stay off the shared registry and its lock
+  bool seen = false;
+  for_each_live_block([&](void* ptr, size_t) { seen = seen || ptr == large; });
+  EXPECT_FALSE(seen);
+
+  // Turning tracking off later still lets recorded blocks be erased when freed
+  Heap::set_track_shared_large(true);
+  void* tracked = allocate(300000);
+  ASSERT_NE(tracked, nullptr);
+  Heap::set_track_shared_large(false);
+  deallocate(tracked, 300000);
+  seen = false;
+  for_each_live_block([&](void* ptr, size_t) { seen = seen || ptr == tracked; });
+  EXPECT_FALSE(seen);
+
+  deallocate(large, 300000);
+  Heap::set_track_shared_large(config().track_large);
+}
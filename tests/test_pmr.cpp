@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "nexusalloc/internal/alignment.hpp"
+#include "nexusalloc/pmr.hpp"
+
+using namespace nexusalloc;
+
+TEST(ThreadArenaResourceTest, HonorsAlignment) {
+  std::thread([] {
+    std::pmr::memory_resource* resource = pmr::arena_resource();
+    for (size_t alignment = 1; alignment <= PageTraits::kChunkSize; alignment <<= 1) {
+      for (size_t bytes : {size_t{1}, size_t{48}, size_t{3000}, size_t{100000}}) {
+        void* ptr = resource->allocate(bytes, alignment);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_TRUE(internal::is_aligned(ptr, alignment)) << bytes << " @ " << alignment;
+        std::memset(ptr, 0xCD, bytes);
+        resource->deallocate(ptr, bytes, alignment);
+      }
+    }
+  }).join();
+}
+
+TEST(ThreadArenaResourceTest, BacksPmrContainers) {
+  std::pmr::vector<std::pmr::string> strings(pmr::arena_resource());
+  for (int i = 0; i < 1000; ++i) {
+    strings.emplace_back(std::string(64, static_cast<char>('a' + i % 26)));
+  }
+  EXPECT_EQ(std::string_view(strings[999]), std::string(64, static_cast<char>('a' + 999 % 26)));
+  EXPECT_EQ(strings[0].get_allocator().resource(), pmr::arena_resource());
+}
+
+TEST(ThreadArenaResourceTest, InstancesCompareEqual) {
+  pmr::thread_arena_resource other;
+  EXPECT_TRUE(pmr::arena_resource()->is_equal(other));
+  EXPECT_FALSE(pmr::arena_resource()->is_equal(*std::pmr::new_delete_resource()));
+}
+
+TEST(MonotonicChunkResourceTest, BumpAllocatesAligned) {
+  pmr::monotonic_chunk_resource resource;
+  char* prev = nullptr;
+  for (size_t alignment : {8, 16, 64, 256, 4096}) {
+    void* ptr = resource.allocate(24, alignment);
+    EXPECT_TRUE(internal::is_aligned(ptr, alignment));
+    if (prev != nullptr) {
+      EXPECT_GT(static_cast<char*>(ptr), prev);
+    }
+    prev = static_cast<char*>(ptr);
+  }
+  EXPECT_EQ(resource.chunk_count(), 1u);
+  EXPECT_FALSE(resource.is_equal(*pmr::arena_resource()));
+}
+
+TEST(MonotonicChunkResourceTest, ReleaseReturnsChunksToPool) {
+  pmr::monotonic_chunk_resource resource;
+  {
+    std::pmr::list<std::array<char, 1000>> nodes(&resource);
+    for (int i = 0; i < 5000; ++i) nodes.emplace_back();
+  }
+  const size_t chunks = resource.chunk_count();
+  EXPECT_GE(chunks, 2u);
+
+  const size_t pooled_before = global_page_stack().approximate_size();
+  resource.release();
+  EXPECT_EQ(resource.chunk_count(), 0u);
+  if (config().decay_ms != 0) {
+    EXPECT_EQ(global_page_stack().approximate_size(), pooled_before + chunks);
+  }
+
+  // Still usable after release
+  EXPECT_NE(resource.allocate(64), nullptr);
+}
+
+TEST(MonotonicChunkResourceTest, OversizedRequestsGetOwnMapping) {
+  const size_t large_before = HugepageProvider::stats().large_allocations;
+  {
+    pmr::monotonic_chunk_resource resource;
+    void* ptr = resource.allocate(3 * PageTraits::kChunkSize, 64);
+    EXPECT_TRUE(internal::is_aligned(ptr, 64));
+    std::memset(ptr, 0xEF, 3 * PageTraits::kChunkSize);
+    EXPECT_EQ(resource.chunk_count(), 0u);
+    EXPECT_EQ(HugepageProvider::stats().large_allocations, large_before + 1);
+  }
+  EXPECT_EQ(HugepageProvider::stats().large_allocations, large_before);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "nexusalloc/internal/alignment.hpp"
+#include "nexusalloc/region.hpp"
+
+using namespace nexusalloc;
+
+TEST(RegionTest, BumpAllocatesAligned) {
+  Region region;
+  EXPECT_EQ(region.chunk_count(), 0u);
+
+  char* prev = nullptr;
+  for (size_t alignment : {1, 8, 16, 64, 4096}) {
+    void* ptr = region.allocate(24, alignment);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_TRUE(internal::is_aligned(ptr, alignment));
+    if (prev != nullptr) {
+      EXPECT_GE(static_cast<char*>(ptr), prev + 24);
+    }
+    prev = static_cast<char*>(ptr);
+  }
+  EXPECT_EQ(region.chunk_count(), 1u);
+}
+
+TEST(RegionTest, ResetKeepsOneChunkAndReturnsTheRest) {
+  Region region;
+  for (int i = 0; i < 3 * 1024; ++i) {
+    void* ptr = region.allocate(2048);
+    ASSERT_NE(ptr, nullptr);
+    std::memset(ptr, 0x5A, 2048);
+  }
+  const size_t chunks = region.chunk_count();
+  ASSERT_GE(chunks, 3u);
+
+  const size_t pooled_before = global_page_stack().approximate_size();
+  region.reset();
+  EXPECT_EQ(region.chunk_count(), 1u);
+  if (config().decay_ms != 0) {
+    EXPECT_EQ(global_page_stack().approximate_size(), pooled_before + chunks - 1);
+  }
+
+  // The kept chunk is rewound and reused
+  void* first = region.allocate(16);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(region.chunk_count(), 1u);
+
+  region.release();
+  EXPECT_EQ(region.chunk_count(), 0u);
+  if (config().decay_ms != 0) {
+    EXPECT_EQ(global_page_stack().approximate_size(), pooled_before + chunks);
+  }
+}
+
+TEST(RegionTest, OversizedAllocationsAreUnmappedOnReset) {
+  const size_t large_before = HugepageProvider::stats().large_allocations;
+  Region region;
+  void* ptr = region.allocate(4 * PageTraits::kChunkSize, 4096);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(internal::is_aligned(ptr, 4096));
+  std::memset(ptr, 0, 4 * PageTraits::kChunkSize);
+  EXPECT_EQ(region.chunk_count(), 0u);
+  EXPECT_EQ(HugepageProvider::stats().large_allocations, large_before + 1);
+
+  region.reset();
+  EXPECT_EQ(HugepageProvider::stats().large_allocations, large_before);
+}
+
+TEST(RegionTest, MoveTransfersChunks) {
+  Region a;
+  ASSERT_NE(a.allocate(64), nullptr);
+  Region b(std::move(a));
+  EXPECT_EQ(a.chunk_count(), 0u);
+  EXPECT_EQ(b.chunk_count(), 1u);
+
+  a = std::move(b);
+  EXPECT_EQ(a.chunk_count(), 1u);
+  EXPECT_EQ(b.chunk_count(), 0u);
+}
+
+TEST(RegionAllocatorTest, BacksStlContainers) {
+  Region region;
+  {
+    using Alloc = RegionAllocator<std::pair<const int, std::string>>;
+    std::map<int, std::string, std::less<int>, Alloc> map{Alloc(region)};
+    std::vector<int, RegionAllocator<int>> vec{RegionAllocator<int>(region)};
+    for (int i = 0; i < 1000; ++i) {
+      map.emplace(i, std::to_string(i));
+      vec.push_back(i);
+    }
+    EXPECT_EQ(map.at(999), "999");
+    EXPECT_EQ(vec.back(), 999);
+
+    // Rebound copies share the region
+    RegionAllocator<double> rebound(vec.get_allocator());
+    EXPECT_EQ(rebound.region(), &region);
+    EXPECT_TRUE(rebound == vec.get_allocator());
+  }
+  region.reset();
+}
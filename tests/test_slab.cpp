@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <sys/mman.h>
+
 #include <set>
+#include <vector>
 
 #include "nexusalloc/hugepage_provider.hpp"
 #include "nexusalloc/slab.hpp"
@@ -128,3 +131,239 @@ TEST_F(SlabTest, OccupancyTracking) {
   EXPECT_TRUE(occupancy.none());
 }
 #endif
+
+TEST_F(SlabTest, ExhaustAndRefill) {
+  Slab<65536> slab(chunk_);
+  chunk_ = nullptr;
+
+  std::set<void*> ptrs;
+  for (size_t i = 0; i < Slab<65536>::kBlocksPerSlab; ++i) {
+    void* ptr = slab.allocate();
+    ASSERT_NE(ptr, nullptr);
+    ptrs.insert(ptr);
+  }
+  EXPECT_EQ(ptrs.size(), Slab<65536>::kBlocksPerSlab);
+  EXPECT_TRUE(slab.full());
+  EXPECT_EQ(slab.allocate(), nullptr);
+
+  void* freed = *ptrs.begin();
+  slab.deallocate(freed);
+  EXPECT_FALSE(slab.full());
+  EXPECT_EQ(slab.allocate(), freed);
+}
+
+TEST_F(SlabTest, BatchTakesFreeListThenBumpRun) {
+  Slab<65536> slab(chunk_);
+  chunk_ = nullptr;
+
+  void* first[4];
+  ASSERT_EQ(slab.allocate_batch(first, 4), 4u);
+  for (size_t i = 1; i < 4; ++i) {
+    EXPECT_EQ(static_cast<char*>(first[i]), static_cast<char*>(first[i - 1]) + 65536);
+  }
+
+  slab.deallocate_batch(first, 2);
+  EXPECT_EQ(slab.used_blocks(), 2u);
+
+  // The two freed blocks come back first, then the bump region continues
+  void* second[3];
+  ASSERT_EQ(slab.allocate_batch(second, 3), 3u);
+  EXPECT_EQ(std::set<void*>(second, second + 2), std::set<void*>(first, first + 2));
+  EXPECT_EQ(static_cast<char*>(second[2]), static_cast<char*>(first[3]) + 65536);
+
+  std::vector<void*> rest(Slab<65536>::kBlocksPerSlab);
+  EXPECT_EQ(slab.allocate_batch(rest.data(), rest.size()), Slab<65536>::kBlocksPerSlab - 5);
+  EXPECT_TRUE(slab.full());
+  EXPECT_EQ(slab.allocate_batch(rest.data(), 1), 0u);
+}
+
+TEST_F(SlabTest, ColorOffsetsBlockArray) {
+  Slab<48> slab(chunk_, 3);
+  void* chunk = chunk_;
+  chunk_ = nullptr;
+
+  void* first = slab.allocate();
+  EXPECT_EQ(first, static_cast<char*>(chunk) + 3 * internal::kCacheLineSize);
+  EXPECT_EQ(slab.free_blocks(), (PageTraits::kChunkSize - 3 * 64) / 48 - 1);
+  EXPECT_EQ(internal::slab_base_from_ptr(first), chunk);
+
+  // The last block still ends inside the chunk
+  void* last = nullptr;
+  while (void* ptr = slab.allocate()) last = ptr;
+  EXPECT_TRUE(slab.full());
+  EXPECT_LE(static_cast<char*>(last) + 48, static_cast<char*>(chunk) + PageTraits::kChunkSize);
+  EXPECT_EQ(internal::slab_base_from_ptr(last), chunk);
+}
+
+TEST_F(SlabTest, BitmapSlabReusesLowestAddressFirst) {
+  BitmapSlab<64> slab(chunk_);
+  void* chunk = chunk_;
+  chunk_ = nullptr;
+
+  std::vector<void*> ptrs(16);
+  for (size_t i = 0; i < ptrs.size(); ++i) {
+    ptrs[i] = slab.allocate();
+    EXPECT_EQ(ptrs[i], static_cast<char*>(chunk) + i * 64);
+  }
+
+  // Freed out of order, handed back in address order
+  slab.deallocate(ptrs[9]);
+  slab.deallocate(ptrs[2]);
+  slab.deallocate(ptrs[5]);
+  EXPECT_EQ(slab.used_blocks(), 13u);
+  EXPECT_FALSE(slab.occupancy().test(5));
+  EXPECT_EQ(slab.allocate(), ptrs[2]);
+  EXPECT_EQ(slab.allocate(), ptrs[5]);
+  EXPECT_EQ(slab.allocate(), ptrs[9]);
+  EXPECT_EQ(slab.allocate(), static_cast<char*>(chunk) + 16 * 64);
+}
+
+TEST_F(SlabTest, BitmapSlabBatchTakesContiguousRuns) {
+  using S = BitmapSlab<65536>;
+  S slab(chunk_);
+  chunk_ = nullptr;
+
+  void* first[8];
+  ASSERT_EQ(slab.allocate_batch(first, 8), 8u);
+  for (size_t i = 1; i < 8; ++i) {
+    EXPECT_EQ(static_cast<char*>(first[i]), static_cast<char*>(first[i - 1]) + 65536);
+  }
+
+  // Free blocks 2-4 and 6: the next batch takes the run, then the gap, then the tail
+  void* holes[] = {first[2], first[3], first[4], first[6]};
+  slab.deallocate_batch(holes, 4);
+  EXPECT_EQ(slab.used_blocks(), 4u);
+
+  void* second[5];
+  ASSERT_EQ(slab.allocate_batch(second, 5), 5u);
+  EXPECT_EQ(second[0], first[2]);
+  EXPECT_EQ(second[1], first[3]);
+  EXPECT_EQ(second[2], first[4]);
+  EXPECT_EQ(second[3], first[6]);
+  EXPECT_EQ(static_cast<char*>(second[4]), static_cast<char*>(first[7]) + 65536);
+
+  std::vector<void*> rest(S::kBlocksPerSlab);
+  EXPECT_EQ(slab.allocate_batch(rest.data(), rest.size()), S::kBlocksPerSlab - 9);
+  EXPECT_TRUE(slab.full());
+  EXPECT_EQ(slab.allocate(), nullptr);
+  EXPECT_EQ(slab.allocate_batch(rest.data(), 1), 0u);
+
+  slab.deallocate(second[1]);
+  EXPECT_FALSE(slab.full());
+  EXPECT_EQ(slab.allocate(), second[1]);
+}
+
+TEST_F(SlabTest, BitmapSlabColorLimitsCapacity) {
+  BitmapSlab<48> slab(chunk_, 3);
+  void* chunk = chunk_;
+  chunk_ = nullptr;
+
+  const size_t capacity = (PageTraits::kChunkSize - 3 * 64) / 48;
+  EXPECT_EQ(slab.free_blocks(), capacity);
+  EXPECT_EQ(slab.allocate(), static_cast<char*>(chunk) + 3 * internal::kCacheLineSize);
+
+  size_t allocated = 1;
+  void* last = nullptr;
+  while (void* ptr = slab.allocate()) {
+    last = ptr;
+    ++allocated;
+  }
+  EXPECT_EQ(allocated, capacity);
+  EXPECT_TRUE(slab.full());
+  EXPECT_LE(static_cast<char*>(last) + 48, static_cast<char*>(chunk) + PageTraits::kChunkSize);
+
+  slab.deallocate(last);
+  slab.deallocate(static_cast<char*>(chunk) + 3 * internal::kCacheLineSize);
+  EXPECT_EQ(slab.free_blocks(), 2u);
+  EXPECT_FALSE(slab.empty());
+}
+
+TEST_F(SlabTest, WalksLiveBlocksInAddressOrder) {
+  auto check = [](auto& slab) {
+    std::vector<void*> live;
+    for (size_t i = 0; i < 200; ++i) live.push_back(slab.allocate());
+    // Free every third block, in reverse, so the free list is not in address order
+    for (size_t i = 201; i-- > 0;) {
+      if (i % 3 == 0 && i < live.size()) {
+        slab.deallocate(live[i]);
+        live.erase(live.begin() + static_cast<ptrdiff_t>(i));
+      }
+    }
+
+    std::vector<void*> walked;
+    slab.for_each_live_block([&](void* block) { walked.push_back(block); });
+    EXPECT_EQ(walked, live);
+  };
+
+  {
+    Slab<48> slab(chunk_, 5);
+    check(slab);
+  }
+  {
+    BitmapSlab<48> slab(chunk_, 5);
+    check(slab);
+  }
+  Slab<48> empty(chunk_);
+  size_t visited = 0;
+  empty.for_each_live_block([&](void*) { ++visited; });
+  EXPECT_EQ(visited, 0u);
+}
+
+TEST(SlabColorTest, PowerOfTwoClassesKeepSizeAlignment) {
+  static_assert(Slab<16>::kColorStep == internal::kCacheLineSize);
+  static_assert(Slab<48>::kColors == PageTraits::kRegularPageSize / internal::kCacheLineSize);
+  static_assert(Slab<1024>::kColorStep == 1024 && Slab<1024>::kColors == 4);
+  static_assert(Slab<4096>::kColors == 1 && Slab<65536>::kColors == 1);
+
+  void* chunk = HugepageProvider::allocate_chunk();
+  ASSERT_NE(chunk, nullptr);
+  for (size_t color = 0; color < 8; ++color) {
+    Slab<1024> slab(chunk, color);
+    void* ptr = slab.allocate();
+    EXPECT_TRUE(internal::is_aligned(ptr, 1024));
+    EXPECT_EQ(ptr, static_cast<char*>(chunk) + (color % 4) * 1024);
+    slab.deallocate(ptr);
+  }
+  HugepageProvider::deallocate_chunk(chunk);
+}
+
+TEST(SlabLazyTest, ConstructionLeavesPagesUntouched) {
+  const PageMode original_mode = HugepageProvider::page_mode();
+  const PopulatePolicy original_policy = HugepageProvider::populate_policy();
+  HugepageProvider::set_page_mode(PageMode::kRegular);  // THP would fault 2MB at once
+  HugepageProvider::set_populate_policy(PopulatePolicy::kLazy);
+
+  void* chunk = HugepageProvider::allocate_chunk();
+  ASSERT_NE(chunk, nullptr);
+
+  constexpr size_t kPages = PageTraits::kChunkSize / PageTraits::kRegularPageSize;
+  auto resident_pages = [chunk] {
+    std::vector<unsigned char> residency(kPages);
+    EXPECT_EQ(mincore(chunk, PageTraits::kChunkSize, residency.data()), 0);
+    size_t resident = 0;
+    for (unsigned char page : residency) resident += page & 1;
+    return resident;
+  };
+
+  {
+    Slab<64> slab(chunk);
+    EXPECT_EQ(resident_pages(), 0u);
+
+    // One block in use means one page in use
+    *static_cast<char*>(slab.allocate()) = 1;
+    EXPECT_EQ(resident_pages(), 1u);
+  }
+  {
+    // The bitmap engine keeps no metadata in the blocks: cycling every block touches nothing
+    BitmapSlab<64> slab(chunk);
+    std::vector<void*> ptrs(BitmapSlab<64>::kBlocksPerSlab);
+    ASSERT_EQ(slab.allocate_batch(ptrs.data(), ptrs.size()), ptrs.size());
+    slab.deallocate_batch(ptrs.data(), ptrs.size());
+    EXPECT_NE(slab.allocate(), nullptr);
+    EXPECT_EQ(resident_pages(), 1u);
+  }
+
+  HugepageProvider::deallocate_chunk(chunk);
+  HugepageProvider::set_populate_policy(original_policy);
+  HugepageProvider::set_page_mode(original_mode);
+}
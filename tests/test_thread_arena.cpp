@@ -2,6 +2,8 @@
 
 #include <cstring>
 #include <set>
+#include <thread>
+#include <vector>
 
 #include "nexusalloc/thread_arena.hpp"
 
@@ -92,3 +94,190 @@ TEST(ThreadArenaTest, CrossSizeClassDeallocation) {
   ThreadArena::get().deallocate(ptr1024, 1024);
   ThreadArena::get().deallocate(ptr64, 64);
 }
+
+TEST(ThreadArenaTest, WarmupPrefillsSizeClasses) {
+  // Run on a fresh thread so the arena starts cold
+  std::thread([] {
+    ThreadArena& arena = ThreadArena::get();
+    constexpr size_t kBlocks = 100000;  // More than one 64-byte slab holds
+
+    const size_t sizes[] = {64, 1024};
+    ASSERT_TRUE(arena.warmup(sizes, kBlocks));
+
+    // Every subsequent allocation is served from slabs acquired by warmup
+    const size_t mapped_before = HugepageProvider::stats().chunks_mapped;
+    const size_t pooled_before = global_page_stack().approximate_size();
+
+    std::vector<void*> ptrs;
+    ptrs.reserve(kBlocks);
+    for (size_t i = 0; i < kBlocks; ++i) {
+      void* ptr = arena.allocate(64);
+      ASSERT_NE(ptr, nullptr);
+      ptrs.push_back(ptr);
+    }
+    void* big = arena.allocate(1000);
+    ASSERT_NE(big, nullptr);
+
+    EXPECT_EQ(HugepageProvider::stats().chunks_mapped, mapped_before);
+    EXPECT_EQ(global_page_stack().approximate_size(), pooled_before);
+
+    arena.deallocate(big, 1000);
+    for (void* ptr : ptrs) {
+      arena.deallocate(ptr, 64);
+    }
+  }).join();
+}
+
+TEST(ThreadArenaTest, WarmupByClassMask) {
+  std::thread([] {
+    ThreadArena& arena = ThreadArena::get();
+    ASSERT_TRUE(arena.warmup(ThreadArena::kAllClasses));
+
+    const size_t mapped_before = HugepageProvider::stats().chunks_mapped;
+    const size_t pooled_before = global_page_stack().approximate_size();
+    for (size_t size : internal::SizeClass::sizes()) {
+      void* ptr = arena.allocate(size);
+      ASSERT_NE(ptr, nullptr);
+      arena.deallocate(ptr, size);
+    }
+    EXPECT_EQ(HugepageProvider::stats().chunks_mapped, mapped_before);
+    EXPECT_EQ(global_page_stack().approximate_size(), pooled_before);
+  }).join();
+}
+
+TEST(ThreadArenaTest, EmptySlabLimitReturnsChunks) {
+  std::thread([] {
+    ThreadArena& arena = ThreadArena::get();
+    arena.set_empty_slab_limit(0);
+    EXPECT_EQ(arena.empty_slab_limit(), 0u);
+
+    // Two slabs' worth of 64KB blocks: the first slab ends up full and off the fast path
+    constexpr size_t kSize = 65536;
+    constexpr size_t kBlocksPerSlab = PageTraits::kChunkSize / kSize;
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < 2 * kBlocksPerSlab; ++i) {
+      void* ptr = arena.allocate(kSize);
+      ASSERT_NE(ptr, nullptr);
+      ptrs.push_back(ptr);
+    }
+
+    const size_t pooled_before = global_page_stack().approximate_size();
+    for (size_t i = 0; i < kBlocksPerSlab; ++i) {
+      arena.deallocate(ptrs[i], kSize);
+    }
+    EXPECT_EQ(global_page_stack().approximate_size(), pooled_before + 1);
+
+    for (size_t i = kBlocksPerSlab; i < ptrs.size(); ++i) {
+      arena.deallocate(ptrs[i], kSize);
+    }
+  }).join();
+}
+
+TEST(ThreadArenaTest, BatchSpansSlabs) {
+  std::thread([] {
+    ThreadArena& arena = ThreadArena::get();
+
+    // Three slabs' worth of 64KB blocks, so the batch rotates through fresh slabs
+    constexpr size_t kSize = 65536;
+    constexpr size_t kCount = 3 * PageTraits::kChunkSize / kSize;
+    std::vector<void*> ptrs(kCount);
+    ASSERT_EQ(arena.allocate_batch(kSize, ptrs.data(), kCount), kCount);
+    EXPECT_EQ(std::set<void*>(ptrs.begin(), ptrs.end()).size(), kCount);
+    for (void* ptr : ptrs) {
+      std::memset(ptr, 0xAB, kSize);
+    }
+
+    // Free in an interleaved order so some runs land on full slabs off the fast path
+    std::vector<void*> order;
+    for (size_t i = 0; i < kCount; i += 2) order.push_back(ptrs[i]);
+    for (size_t i = 1; i < kCount; i += 2) order.push_back(ptrs[i]);
+    arena.deallocate_batch(order.data(), order.size(), kSize);
+
+    // Every block is reusable afterwards
+    std::vector<void*> again(kCount);
+    ASSERT_EQ(arena.allocate_batch(kSize, again.data(), kCount), kCount);
+    EXPECT_EQ(std::set<void*>(again.begin(), again.end()),
+              std::set<void*>(ptrs.begin(), ptrs.end()));
+    arena.deallocate_batch(again.data(), kCount, kSize);
+  }).join();
+}
+
+TEST(ThreadArenaTest, BatchLargeAndNull) {
+  void* ptrs[3] = {};
+  ASSERT_EQ(ThreadArena::get().allocate_batch(1 << 20, ptrs, 2), 2u);
+  EXPECT_NE(ptrs[0], ptrs[1]);
+  ThreadArena::get().deallocate_batch(ptrs, 3, 1 << 20);  // ptrs[2] is null and skipped
+}
+
+TEST(ThreadArenaTest, BoundLazilyAndReleasedAtThreadExit) {
+  struct FreeAtExit {
+    void* ptr{nullptr};
+    ~FreeAtExit() { ThreadArena::get().deallocate(ptr, 64); }
+  };
+
+  ThreadArena::set_pool_limit(0);
+  size_t chunks = 0;
+  size_t pooled_before = 0;
+  std::thread([&chunks, &pooled_before] {
+    EXPECT_EQ(ThreadArena::current(), nullptr);
+    ThreadArena& arena = ThreadArena::get();
+    EXPECT_EQ(ThreadArena::current(), &arena);
+
+    // thread_local destructors run before the arena is torn down and may still free into it
+    thread_local FreeAtExit pending;
+    pending.ptr = arena.allocate(64);
+    ASSERT_NE(pending.ptr, nullptr);
+    chunks = arena.chunk_count();
+    pooled_before = global_page_stack().approximate_size();
+  }).join();
+  ThreadArena::reset_pool_limit();
+
+  // With no room in the arena pool the arena is destroyed and its chunks go back to the page pool
+  EXPECT_GT(chunks, 0u);
+  if (config().decay_ms != 0) {
+    EXPECT_GE(global_page_stack().approximate_size(), pooled_before + chunks);
+  }
+}
+
+TEST(ThreadArenaTest, PoolLimitUnlimitedAndReset) {
+  ThreadArena::set_pool_limit(Config::kUnlimited);
+  EXPECT_EQ(ThreadArena::pool_limit(), Config::kUnlimited);
+  ThreadArena::reset_pool_limit();
+  EXPECT_EQ(ThreadArena::pool_limit(), config().arena_pool);
+}
+
+TEST(ThreadArenaTest, NewThreadAdoptsParkedArena) {
+  ThreadArena::set_pool_limit(4);
+  ThreadArena::release_parked();
+
+  ThreadArena* first = nullptr;
+  void* leftover = nullptr;
+  std::thread([&] {
+    first = &ThreadArena::get();
+    first->set_empty_slab_limit(0);
+    leftover = first->allocate(128);
+  }).join();
+  ASSERT_NE(leftover, nullptr);
+  EXPECT_EQ(ThreadArena::parked_count(), 1u);
+
+  std::thread([&] {
+    // Same arena, warm slab included: the next block comes from it without a new chunk
+    const size_t mapped_before = HugepageProvider::stats().chunks_mapped;
+    const size_t pooled_before = global_page_stack().approximate_size();
+    ThreadArena& arena = ThreadArena::get();
+    EXPECT_EQ(&arena, first);
+    EXPECT_EQ(arena.empty_slab_limit(), config().thread_cache_slabs);
+    void* ptr = arena.allocate(128);
+    EXPECT_EQ(internal::slab_base_from_ptr(ptr), internal::slab_base_from_ptr(leftover));
+    EXPECT_EQ(HugepageProvider::stats().chunks_mapped, mapped_before);
+    EXPECT_EQ(global_page_stack().approximate_size(), pooled_before);
+
+    // Blocks the previous owner left allocated now belong to this thread
+    arena.deallocate(leftover, 128);
+    arena.deallocate(ptr, 128);
+  }).join();
+
+  EXPECT_EQ(ThreadArena::release_parked(), 1u);
+  EXPECT_EQ(ThreadArena::parked_count(), 0u);
+  ThreadArena::reset_pool_limit();
+}
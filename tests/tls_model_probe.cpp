@@ -0,0 +1,23 @@
+// Built as a shared library by tests/CMakeLists.txt: check_tls_get_addr.cmake then verifies that
+// reaching the calling thread's arena from a shared object needs no __tls_get_addr call.
+
+#include <cstddef>
+
+#include "nexusalloc/thread_arena.hpp"
+
+extern "C" [[gnu::visibility("default")]] void* nexusalloc_probe_allocate(size_t size) {
+  return nexusalloc::ThreadArena::get().allocate(size);
+}
+
+extern "C" [[gnu::visibility("default")]] void nexusalloc_probe_deallocate(void* ptr, size_t size) {
+  nexusalloc::ThreadArena::get().deallocate(ptr, size);
+}
+
+#ifdef NEXUSALLOC_TLS_CONTROL
+// The control build adds a default-model thread-local, which must make the check fail
+__thread int control_counter = 0;
+
+extern "C" [[gnu::visibility("default")]] int nexusalloc_probe_control() {
+  return ++control_counter;
+}
+#endif